@@ -5,6 +5,10 @@ set(FATAL_ASSERTS_ENABLED OFF CACHE STRING "Enable fatal assert" FORCE)
 
 set(ENABLE_TRANSPOSITION_TABLE ON CACHE STRING "Enable fatal assert" FORCE)
 set(ENABLE_LATE_MOVE_REDUCTION ON CACHE STRING "Enable late move reduction" FORCE)
+set(ENABLE_QUIESCENCE_CHECKS OFF CACHE STRING "Search quiet checking moves at the first quiescence ply" FORCE)
+option(ENABLE_COPY_MAKE "Restore the board from a per ply copy instead of unmaking moves" OFF)
+option(USE_PEXT "Index slider attack tables with BMI2 pext instead of magic numbers" OFF)
+option(ENABLE_CPU_DISPATCH "Build hot paths for several instruction set levels and pick one at startup" ON)
 
 
 set(PRECOMPILE_OPTIONS
@@ -14,4 +18,8 @@ set(PRECOMPILE_OPTIONS
     FATAL_ASSERTS_ENABLED
     ENABLE_TRANSPOSITION_TABLE
     ENABLE_LATE_MOVE_REDUCTION
+    ENABLE_QUIESCENCE_CHECKS
+    ENABLE_COPY_MAKE
+    USE_PEXT
+    ENABLE_CPU_DISPATCH
 )
\ No newline at end of file
@@ -147,8 +147,9 @@ DivideDepthCommand(std::list<std::string>& tokens, GameContext& context)
 
         u64 total = 0;
         u16 moves = 0;
+        context.ReserveStates(depth);
 
-        movGen.forEachMove([&](const PrioratizedMove& pm) {
+        for (const PrioratizedMove& pm : movGen) {
             std::cout << " " << pm.move.toString();
             if (pm.move.isPromotion()) {
                 // using black here since we want to print the type in lowercase.
@@ -163,7 +164,7 @@ DivideDepthCommand(std::list<std::string>& tokens, GameContext& context)
             total += result.Nodes;
             moves++;
             context.UnmakeMove();
-        });
+        }
 
         std::cout << "\n Moves: " << moves << "\n";
         std::cout << " Total: " << total << "\n";
@@ -326,9 +327,9 @@ AvailableMovesCommand(std::list<std::string>&, GameContext& context)
     params.SearchDepth = 1;
     //params.QuiescenceDepth = 2;
     Evaluator evaluator;
+    context.ReserveStates(1);
 
-    moveGen.forEachMove([&](const PrioratizedMove& pm) {
-        bool maximizingPlayer = context.readToPlay() == Set::WHITE;
+    for (const PrioratizedMove& pm : moveGen) {
         context.MakeMove(pm.move);
         std::cout << " " << pm.move.toString();
         if (pm.move.isPromotion()) {
@@ -339,10 +340,10 @@ AvailableMovesCommand(std::list<std::string>&, GameContext& context)
         // auto bestmove = search.CalculateBestMove(context, params);
         i32 evaluation = evaluator.Evaluate(context.readChessboard(), moveGen);
 
-        i32 score = search.CalculateMove(context, maximizingPlayer, 3);
+        i32 score = search.CalculateMove(context, 3);
         std::cout << ": " << evaluation << " <" << score << ">\n";
         context.UnmakeMove();
-        });
+    }
 
     std::cout << std::endl;
     return true;
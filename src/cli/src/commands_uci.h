@@ -62,7 +62,9 @@ static UCICommandsMap commands = {
 
 static UCIOptionsMap options = {
     { "Threads", "type spin default 1 min 1 max 24" },
-    { "Hash", "type spin default 8 min 1 max 1024"}
+    { "Hash", "type spin default 8 min 1 max 1024"},
+    { "MultiPV", "type spin default 1 min 1 max 256" },
+    { "NumaPlacement", "type combo default FirstTouch var FirstTouch var Interleave" }
 };
 
 } // namespace UCICommands
\ No newline at end of file
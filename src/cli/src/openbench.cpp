@@ -1,14 +1,19 @@
+#include <array>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <vector>
 
+#include "attacks/attacks.hpp"
 #include "clock.hpp"
 #include "commands_uci.h"
 #include "game_context.h"
 #include "fen_parser.h"
+#include "mate_search.hpp"
+#include "move_generator.hpp"
+#include "numa.hpp"
 #include "search.hpp"
-#include "static_initializer.hpp"
-
-bool g_initialized = static_initializer::initialize();
 
 constexpr u32 depth = 6;
 static const std::vector<std::string> fens = {
@@ -79,21 +84,279 @@ void bench() {
     }
 
     timer.Stop();
-    i64 elapsedSeconds = timer.getElapsedTime() / 1000;
-    std::cout << "info string " << elapsedSeconds << " seconds\n";
-    std::cout << nodes << " nodes " << nodes / elapsedSeconds << " nps\n";
+    // a bench under a second would otherwise divide by zero.
+    const i64 elapsed = std::max<i64>(1, timer.getElapsedTime());
+    std::cout << "info string " << elapsed / 1000.0 << " seconds\n";
+    std::cout << nodes << " nodes " << nodes * 1000 / elapsed << " nps\n";
 }
 
 
 
-int main(int argc, char* argv[]) {
-    assert(g_initialized);
+// runs the bench positions on every thread at once, each thread pinned and searching its own game
+// but all of them sharing one transposition table, which is what the page placement is about.
+void numabench(u32 maxThreads, const std::vector<numa::Placement>& placements) {
+    constexpr u32 tableSize = 256;
+    const auto& topology = numa::Topology::Instance();
+    std::cout << "info string " << topology.readNodeCount() << " numa nodes, " << topology.readCpuCount() << " cpus\n";
+    for (const auto& node : topology.readNodes())
+        std::cout << "info string node " << node.id << " " << node.cpus.size() << " cpus\n";
+
+    TranspositionTable table;
+    for (numa::Placement placement : placements) {
+        const char* placementName = placement == numa::Placement::Interleave ? "interleave" : "firsttouch";
+        double singleThreadNps = 0;
+        for (u32 threads = 1; threads <= maxThreads; threads *= 2) {
+            // a fresh allocation filled by one bound thread per worker, spread like the search.
+            table.setPlacement(threads, placement);
+            table.resize(tableSize);
+
+            std::vector<std::unique_ptr<GameContext>> contexts;
+            for (u32 threadIndex = 0; threadIndex < threads; ++threadIndex) {
+                contexts.push_back(std::make_unique<GameContext>());
+                contexts.back()->shareTranspositionTable(table);
+            }
+
+            std::vector<u64> nodes(threads, 0);
+            std::vector<std::thread> workers;
+
+            Clock timer;
+            timer.Start();
+            for (u32 threadIndex = 0; threadIndex < threads; ++threadIndex) {
+                workers.emplace_back([&, threadIndex]() {
+                    numa::bindThread(threadIndex);
+                    GameContext& context = *contexts[threadIndex];
+                    for (const auto& fen : fens) {
+                        FENParser::deserialize(fen.c_str(), context);
+                        Search search;
+                        nodes[threadIndex] += search.Bench(context, depth - 1);
+                    }
+                });
+            }
+            for (auto& worker : workers)
+                worker.join();
+            timer.Stop();
+
+            u64 totalNodes = 0;
+            for (u64 count : nodes)
+                totalNodes += count;
+            const double nps = totalNodes * 1000.0 / std::max<i64>(1, timer.getElapsedTime());
+            if (threads == 1)
+                singleThreadNps = nps;
+            std::cout << placementName << " " << threads << " threads " << totalNodes << " nodes " << (u64)nps << " nps "
+                << nps / singleThreadNps << "x\n";
+        }
+    }
+}
+
+// repeatedly makes and unmakes every legal move of the bench positions.
+void makebench() {
+    constexpr u32 iterations = 20000;
+    u64 moves = 0;
+    u64 checksum = 0;
+
+    Clock timer;
+    timer.Start();
+    for (const auto& fen : fens) {
+        GameContext context;
+        FENParser::deserialize(fen.c_str(), context);
+
+        std::vector<PackedMove> legalMoves;
+        MoveGenerator generator(context);
+        generator.generate();
+        for (const PrioratizedMove& pm : generator)
+            legalMoves.push_back(pm.move);
+
+        for (u32 i = 0; i < iterations; ++i) {
+            for (PackedMove move : legalMoves) {
+                context.MakeMove(move);
+                checksum += context.readChessboard().readHash();
+                context.UnmakeMove();
+            }
+        }
+        moves += legalMoves.size() * iterations;
+    }
+    timer.Stop();
+
+    const i64 elapsed = std::max<i64>(1, timer.getElapsedTime());
+    std::cout << moves << " make/unmake " << elapsed << " ms " << moves / elapsed * 1000 << " per second\n";
 
+    // piece lookups on every square, as done by make, capture handling and move parsing.
+    u64 lookups = 0;
+    timer.Start();
+    for (const auto& fen : fens) {
+        GameContext context;
+        FENParser::deserialize(fen.c_str(), context);
+        const auto& position = context.readChessboard().readPosition();
+        for (u32 i = 0; i < iterations * 10; ++i) {
+            for (u8 sqr = 0; sqr < 64; ++sqr)
+                checksum += position.readPieceAt(static_cast<Square>(sqr)).index();
+        }
+        lookups += 64ull * iterations * 10;
+    }
+    timer.Stop();
+
+    const i64 lookupElapsed = std::max<i64>(1, timer.getElapsedTime());
+    std::cout << lookups << " piece lookups " << lookupElapsed << " ms " << lookups / lookupElapsed * 1000 << " per second\n";
+    std::cout << "info string checksum " << checksum << "\n";
+}
+
+// raw slider attack lookups on pseudo random occupancies, compares the magic and pext backends
+// when the binary is built with and without USE_PEXT.
+void attackbench() {
+    constexpr u32 iterations = 200000;
+    std::array<u64, 256> occupancies;
+    u64 seed = 0x9E3779B97F4A7C15ull;
+    for (auto& occupancy : occupancies) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        occupancy = seed & (seed >> 5);
+    }
+
+    u64 checksum = 0;
+    Clock timer;
+    timer.Start();
+    for (u32 i = 0; i < iterations; ++i) {
+        const u64 occupancy = occupancies[i & 255];
+        for (u8 sqr = 0; sqr < 64; ++sqr)
+            checksum += attacks::getRookAttacks(sqr, occupancy) ^ attacks::getBishopAttacks(sqr, occupancy);
+    }
+    timer.Stop();
+
+    const u64 lookups = 2ull * 64 * iterations;
+    const i64 elapsed = std::max<i64>(1, timer.getElapsedTime());
+    std::cout << attacks::c_sliderBackend << " " << lookups << " lookups " << elapsed << " ms "
+        << lookups / elapsed * 1000 << " per second\n";
+    std::cout << "info string checksum " << checksum << "\n";
+}
+
+// perft from the start position and kiwipete, dominated by move generation and make/unmake.
+void perftbench() {
+    static const std::vector<std::pair<std::string, int>> perftFens = {
+        { "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5 },
+        { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4 },
+    };
+
+    u64 nodes = 0;
+    Clock timer;
+    timer.Start();
+    for (const auto& [fen, perftDepth] : perftFens) {
+        GameContext context;
+        FENParser::deserialize(fen.c_str(), context);
+        Search search;
+        nodes += search.Perft(context, perftDepth).Nodes;
+    }
+    timer.Stop();
+
+    const i64 elapsed = std::max<i64>(1, timer.getElapsedTime());
+    std::cout << nodes << " nodes " << elapsed << " ms " << nodes / elapsed * 1000 << " nps\n";
+}
+
+struct MateBenchCase {
+    std::string fen;
+    u32 mateIn;
+};
+
+// forced mates delivered by a sequence of checks.
+static const std::vector<MateBenchCase> mateFens = {
+    { "6rk/6pp/8/6N1/8/8/8/7K w - - 0 1", 1 },
+    { "r5k1/5ppp/8/8/8/8/5PPP/6K1 b - - 0 1", 1 },
+    { "2q1nk1r/4Rp2/1ppp1P2/6Pp/3p1B2/3P3P/PPP1Q3/6K1 w - - 0 1", 5 },
+    { "6r1/p3p1rk/1p1pPp1p/q3n2R/4P3/3BR2P/PPP2QP1/7K w - - 0 1", 5 },
+};
+
+void matebench() {
+    u64 solverNodes = 0, searchNodes = 0;
+    i64 solverTime = 0, searchTime = 0;
+
+    for (const auto& mateCase : mateFens) {
+        GameContext context;
+        FENParser::deserialize(mateCase.fen.c_str(), context);
+
+        SearchParameters params;
+        params.MateIn = mateCase.mateIn;
+        params.SearchDepth = mateCase.mateIn * 2;
+
+        Clock timer;
+        timer.Start();
+        MateSearch solver;
+        MateSearchResult mate = solver.Solve(context, params);
+        i64 elapsed = timer.getElapsedTime();
+        solverNodes += mate.nodes;
+        solverTime += elapsed;
+        std::cout << "info string solver mate " << mate.mateIn << " " << mate.move.toString()
+            << " nodes " << mate.nodes << " time " << elapsed << "\n";
+
+        timer.Start();
+        Search search;
+        SearchResult result = search.CalculateBestMove(context, params);
+        elapsed = timer.getElapsedTime();
+        searchNodes += result.count;
+        searchTime += elapsed;
+        std::cout << "info string search " << result.move.toString() << " nodes " << result.count
+            << " time " << elapsed << "\n";
+    }
+
+    std::cout << "solver " << solverNodes << " nodes " << solverTime << " ms\n";
+    std::cout << "search " << searchNodes << " nodes " << searchTime << " ms\n";
+}
+
+// launches the engine over and over, the way tournament runners start short lived processes. The
+// children exit right away so this measures process creation, loading and static initialization.
+void startupbench(const char* executable, u32 runs) {
+    const std::string command = std::string("\"") + executable + "\" startup";
+    Clock timer;
+    timer.Start();
+    for (u32 i = 0; i < runs; ++i) {
+        if (std::system(command.c_str()) != 0) {
+            std::cout << "info string failed to launch " << executable << "\n";
+            return;
+        }
+    }
+    timer.Stop();
+
+    const i64 elapsed = std::max<i64>(1, timer.getElapsedTime());
+    std::cout << runs << " launches " << elapsed << " ms " << (elapsed * 1000) / runs << " us per launch\n";
+}
+
+int main(int argc, char* argv[]) {
     if (argc > 1) {
+        if (std::string(argv[1]) == "startup") {
+            return 0;
+        }
+        if (std::string(argv[1]) == "startupbench") {
+            startupbench(argv[0], argc > 2 ? std::stoul(argv[2]) : 200);
+            return 0;
+        }
         if (std::string(argv[1]) == "bench") {
             bench();
             return 0;
         }
+        if (std::string(argv[1]) == "makebench") {
+            makebench();
+            return 0;
+        }
+        if (std::string(argv[1]) == "attackbench") {
+            attackbench();
+            return 0;
+        }
+        if (std::string(argv[1]) == "perftbench") {
+            perftbench();
+            return 0;
+        }
+        if (std::string(argv[1]) == "numabench") {
+            const u32 maxThreads = argc > 2 ? std::stoul(argv[2]) : std::max(1u, std::thread::hardware_concurrency());
+            // both placements unless one is asked for.
+            std::vector<numa::Placement> placements = { numa::Placement::FirstTouch, numa::Placement::Interleave };
+            if (argc > 3)
+                placements = { std::string(argv[3]) == "interleave" ? numa::Placement::Interleave : numa::Placement::FirstTouch };
+            numabench(maxThreads, placements);
+            return 0;
+        }
+        if (std::string(argv[1]) == "matebench") {
+            matebench();
+            return 0;
+        }
     }
 
     UCICommands::UCIEnable();
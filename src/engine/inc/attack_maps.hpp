@@ -0,0 +1,57 @@
+// Elephant Gambit Chess Engine - a Chess AI
+// Copyright(C) 2021-2024  Alexander Loodin Ek
+
+// This program is free software : you can redistribute it and /or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see < http://www.gnu.org/licenses/>.
+#pragma once
+#include "bitboard.hpp"
+#include "chess_piece_defines.hpp"
+#include "defines.hpp"
+
+class Position;
+
+/**
+ * @brief Squares attacked by each side, by each of its piece types and by every single piece of
+ * a position. A side is computed with magic lookups the first time any of its attacks are read,
+ * so a node builds them at most once no matter how often move generation and the exchange
+ * evaluation ask for them. No evaluation term reads them yet.
+ *
+ * Sliders look through the opposing king, a king stepping back along the ray of a checking
+ * slider is still in check. This makes the maps directly usable for king move legality and a
+ * slight superset of the plain attacks for everything else.  */
+class AttackMaps {
+public:
+    explicit AttackMaps(const Position& position);
+
+    [[nodiscard]] Bitboard bySet(Set set) const;
+    [[nodiscard]] Bitboard byPiece(Set set, u8 pieceId) const;
+
+    /**
+     * @brief Attacks of the piece standing on sqr, empty if the square is empty.  */
+    [[nodiscard]] Bitboard bySquare(Square sqr) const;
+
+    [[nodiscard]] bool isAttacked(Set set, Square sqr) const { return bySet(set)[sqr]; }
+
+private:
+    template<Set set>
+    void compute() const;
+    void ensure(Set set) const;
+
+    const Position& m_position;
+
+    // lazily filled from const accessors, readers only ever hold a const generator.
+    mutable bool m_computed[2];
+    mutable Bitboard m_bySet[2];
+    mutable Bitboard m_byPiece[2][6];
+    mutable Bitboard m_bySquare[64];
+};
@@ -8,14 +8,42 @@
 #include "intrinsics.hpp"
 #include "magic_constants.hpp"
 
+#if defined(USE_PEXT) && !defined(__BMI2__)
+#error "USE_PEXT requires a BMI2 capable target, i.e. -mbmi2 or -march=native"
+#endif
+
 namespace attacks {
-namespace tables {
-const std::array<u64, 64>& getKnightAttacks();
-const std::array<u64, 64>& getRookAttacks();
-const std::array<u64, 64>& getBishopAttacks();
-const std::array<std::array<u64, 4096>, 64>& getRookAttacksTable();
-const std::array<std::array<u64, 1024>, 64>& getBishopAttacksTable();
-} // namespace tables
+
+// name of the slider attack backend compiled in, reported by the benchmarks.
+#if defined(USE_PEXT)
+constexpr const char* c_sliderBackend = "pext";
+#else
+constexpr const char* c_sliderBackend = "magic";
+#endif
+
+namespace internals {
+    /**
+     * @brief Start of every square's slice in the packed slider table. A square only needs
+     * 2^bits entries for the bits of its relevant occupancy, instead of the 4096 (rook) and
+     * 1024 (bishop) slots of the worst case square.  */
+    constexpr std::array<u32, 65> generateTableOffsets(const u64 (&shifts)[64], u32 base) {
+        std::array<u32, 65> offsets{};
+        offsets[0] = base;
+        for (u8 sqr = 0; sqr < 64; ++sqr)
+            offsets[sqr + 1] = offsets[sqr] + (1u << (64 - shifts[sqr]));
+
+        return offsets;
+    }
+
+    // the rook slices come first and the bishop slices follow in the same table.
+    constexpr std::array<u32, 65> rookOffsets = generateTableOffsets(magics::constants::rook_shifts, 0);
+    constexpr std::array<u32, 65> bishopOffsets = generateTableOffsets(magics::constants::bishop_shifts, rookOffsets[64]);
+} // namespace internals
+
+constexpr u32 c_rookTableSize = internals::rookOffsets[64];
+constexpr u32 c_bishopTableSize = internals::bishopOffsets[64] - internals::rookOffsets[64];
+constexpr u32 c_sliderTableSize = internals::bishopOffsets[64];
+static_assert(c_rookTableSize == 102400 && c_bishopTableSize == 5248, "unexpected slider table layout");
 
 namespace internals {
 
@@ -102,6 +130,39 @@ namespace internals {
         return attkMask;
     }
 
+    /**
+     * @brief Squares a pawn of set standing on sqr captures on, white pawns move up the board.  */
+    constexpr u64 generatePawnAttackMask(u8 set, u8 sqr) {
+        const u64 sqrMask = 1ULL << sqr;
+        if (set == 0)
+            return ((sqrMask & ~board_constants::fileaMask) << 7) | ((sqrMask & ~board_constants::filehMask) << 9);
+        return ((sqrMask & ~board_constants::fileaMask) >> 9) | ((sqrMask & ~board_constants::filehMask) >> 7);
+    }
+
+    constexpr u64 generateKingAttackMask(u8 sqr) {
+        const u64 sqrMask = 1ULL << sqr;
+        const u64 sideways = ((sqrMask & ~board_constants::fileaMask) >> 1) | ((sqrMask & ~board_constants::filehMask) << 1);
+        const u64 row = sideways | sqrMask;
+        return sideways | (row << 8) | (row >> 8);
+    }
+
+    constexpr std::array<std::array<u64, 64>, 2> generatePawnAttackTable() {
+        std::array<std::array<u64, 64>, 2> pawnAttacks{};
+        for (u8 set = 0; set < 2; ++set)
+            for (u8 sqr = 0; sqr < 64; ++sqr)
+                pawnAttacks[set][sqr] = generatePawnAttackMask(set, sqr);
+
+        return pawnAttacks;
+    }
+
+    constexpr std::array<u64, 64> generateKingAttackTable() {
+        std::array<u64, 64> kingAttacks{};
+        for (u8 sqr = 0; sqr < 64; ++sqr)
+            kingAttacks[sqr] = generateKingAttackMask(sqr);
+
+        return kingAttacks;
+    }
+
     constexpr std::array<u64, 64> generateKnightAttackTable() {
         std::array<u64, 64> knightAttacks{};
         for (u8 sqr = 0; sqr < 64; ++sqr)
@@ -126,26 +187,101 @@ namespace internals {
         return bishopAttacks;
     }
 
-    void generateRookTable(std::array<std::array<u64, 4096>, 64>& result);
-    void generateBishopTable(std::array<std::array<u64, 1024>, 64>& result);
-    void initialize();
+    constexpr std::array<std::array<u64, 64>, 2> pawnAttacks = generatePawnAttackTable();
+    constexpr std::array<u64, 64> kingAttacks = generateKingAttackTable();
+    constexpr std::array<u64, 64> knightAttacks = generateKnightAttackTable();
+    constexpr std::array<u64, 64> rookAttacks = generateRookAttackTable();
+    constexpr std::array<u64, 64> bishopAttacks = generateBishopAttackTable();
+
+    // baked at compile time in attacks.cpp so startup does no work and the table lives in read
+    // only pages shared between engine processes.
+    extern const std::array<u64, c_sliderTableSize> sliderAttacksTable;
 
 } // namespace internals
 
+namespace tables {
+constexpr const std::array<u64, 64>& getKnightAttacks() {
+    return internals::knightAttacks;
+}
+constexpr const std::array<u64, 64>& getRookAttacks() {
+    return internals::rookAttacks;
+}
+constexpr const std::array<u64, 64>& getBishopAttacks() {
+    return internals::bishopAttacks;
+}
+inline const std::array<u64, c_sliderTableSize>& getSliderAttacksTable() {
+    return internals::sliderAttacksTable;
+}
+} // namespace tables
+
+namespace internals {
+
+    /**
+     * @brief Index into the attack table of sqr for the given occupancy. With PEXT the relevant
+     * occupancy bits are extracted directly, otherwise they are hashed with the magic numbers.
+     * Both fit within the 2^bits entries of the square's slice.  */
+    constexpr u64 rookTableIndex(u8 sqr, u64 occupancy) {
+#if defined(USE_PEXT)
+        return intrinsics::pext(occupancy, tables::getRookAttacks()[sqr]);
+#else
+        u64 key = occupancy & tables::getRookAttacks()[sqr];
+        return (key * magics::constants::rook[sqr]) >> (magics::constants::rook_shifts[sqr]);
+#endif
+    }
+
+    constexpr u64 bishopTableIndex(u8 sqr, u64 occupancy) {
+#if defined(USE_PEXT)
+        return intrinsics::pext(occupancy, tables::getBishopAttacks()[sqr]);
+#else
+        u64 key = occupancy & tables::getBishopAttacks()[sqr];
+        return (key * magics::constants::bishop[sqr]) >> (magics::constants::bishop_shifts[sqr]);
+#endif
+    }
+
+    constexpr void generateRookTable(std::array<u64, c_sliderTableSize>& result) {
+        for (u8 sqr = 0; sqr < 64; ++sqr) {
+            const u64 attkMask = rookAttacks[sqr];
+            const u64 occupancyVariations = 1ULL << intrinsics::popcnt(attkMask);
+
+            for (u64 i = 0; i < occupancyVariations; ++i) {
+                const u64 occupancy = intrinsics::pdep(i, attkMask);
+                result[rookOffsets[sqr] + rookTableIndex(sqr, occupancy)] = generateRookAttackMask<true>(sqr, occupancy);
+            }
+        }
+    }
+
+    constexpr void generateBishopTable(std::array<u64, c_sliderTableSize>& result) {
+        for (u8 sqr = 0; sqr < 64; ++sqr) {
+            const u64 attkMask = bishopAttacks[sqr];
+            const u64 occupancyVariations = 1ULL << intrinsics::popcnt(attkMask);
+
+            for (u64 i = 0; i < occupancyVariations; ++i) {
+                const u64 occupancy = intrinsics::pdep(i, attkMask);
+                result[bishopOffsets[sqr] + bishopTableIndex(sqr, occupancy)] = generateBishopAttackMask<true>(sqr, occupancy);
+            }
+        }
+    }
+
+} // namespace internals
+
+inline u64 getPawnAttacks(u8 set, u8 sqr) {
+    return internals::pawnAttacks[set][sqr];
+}
+
+inline u64 getKingAttacks(u8 sqr) {
+    return internals::kingAttacks[sqr];
+}
+
 inline u64 getKnightAttacks(u8 sqr) {
     return tables::getKnightAttacks()[sqr];
 }
 
 inline u64 getRookAttacks(u8 sqr, u64 occupancy) {
-    u64 key = occupancy & tables::getRookAttacks()[sqr];
-    u64 index = (key * magics::constants::rook[sqr]) >> (magics::constants::rook_shifts[sqr]);
-    return tables::getRookAttacksTable()[sqr][index];
+    return tables::getSliderAttacksTable()[internals::rookOffsets[sqr] + internals::rookTableIndex(sqr, occupancy)];
 }
 
 inline u64 getBishopAttacks(u8 sqr, u64 occupancy) {
-    u64 key = occupancy & tables::getBishopAttacks()[sqr];
-    u64 index = (key * magics::constants::bishop[sqr]) >> (magics::constants::bishop_shifts[sqr]);
-    return tables::getBishopAttacksTable()[sqr][index];
+    return tables::getSliderAttacksTable()[internals::bishopOffsets[sqr] + internals::bishopTableIndex(sqr, occupancy)];
 }
 
 } // namespace attacks
\ No newline at end of file
@@ -49,6 +49,15 @@ struct MoveUndoUnit {
     short plyCount;
 };
 
+/**
+ * @brief Board state copy-make restores on unmake, the position plus the scalars a move changes
+ * which can't simply be stepped back.  */
+struct BoardSnapshot {
+    Position position;
+    u64 hash;
+    short plyCount;
+};
+
 /**
  * The Chessboard class represents a chess board and its current state.
  * It provides functions for moving and placing chess pieces, and updates
@@ -59,16 +68,29 @@ class Chessboard {
 public:
     Chessboard();
     ~Chessboard() = default;
-    Chessboard(const Chessboard& other);
+    // plain member wise copies, copy-make relies on these being cheap.
+    Chessboard(const Chessboard& other) = default;
+    Chessboard& operator=(const Chessboard& other) = default;
 
     void Clear();
     bool PlacePiece(ChessPiece piece, Notation target, bool overwrite = false);
 
     template<bool validation>
     MoveUndoUnit MakeMove(const PackedMove move);
+    /**
+     * @brief Makes move writing the undo information straight into undoState, lets callers keep
+     * a preallocated stack of undo units instead of copying the returned one.  */
+    template<bool validation>
+    void MakeMove(const PackedMove move, MoveUndoUnit& undoState);
 
     bool UnmakeMove(const MoveUndoUnit& undoState);
 
+    /**
+     * @brief Copy-make counterparts of make and unmake, the snapshot is taken before a move and
+     * restoring it takes back that single move.  */
+    void SaveSnapshot(BoardSnapshot& snapshot) const;
+    void RestoreSnapshot(const BoardSnapshot& snapshot);
+
     template<typename... placementpairs>
     bool PlacePieces(placementpairs... placements);
 
@@ -179,7 +201,7 @@ private:
 
     MoveUndoUnit InternalMakeMove(const std::string& moveString);
 
-    std::tuple<Square, ChessPiece> InternalHandlePawnMove(const PackedMove move, Set set, MutableMaterialProxy& materialEditor, MoveUndoUnit& undoState);
+    std::tuple<Square, ChessPiece> InternalHandlePawnMove(const PackedMove move, Set set, MoveUndoUnit& undoState);
     void InternalHandleRookMove(const ChessPiece piece, const PackedMove move, Square targetRook, Square rookMove, MoveUndoUnit& undoState);
     void InternalHandleRookMovedOrCaptured(Notation rookSquare, MoveUndoUnit& undoState);
     void InternalUpdateCastlingState(byte mask, MoveUndoUnit& undoState);
@@ -197,7 +219,7 @@ private:
     void InternalHandleCapture(const PackedMove move, const Square pieceTarget, MoveUndoUnit& undoState);
 
     bool InternalUpdateEnPassant(Notation source, Notation target);
-    void InternalMakeMove(ChessPiece piece, Square source, Square target, MutableMaterialProxy materialEditor);
+    void InternalMakeMove(ChessPiece piece, Square source, Square target);
 
     u64 m_hash;
     Position m_position;
@@ -207,9 +229,6 @@ private:
     short m_plyCount;
     short m_age;
     mutable float m_endGameCoeficient;
-
-    // caching kings and their locations
-    std::pair<ChessPiece, Notation> m_kings[2];
 };
 
 template<typename T, bool isConst>
@@ -0,0 +1,74 @@
+// Elephant Gambit Chess Engine - a Chess AI
+// Copyright(C) 2021-2024  Alexander Loodin Ek
+
+// This program is free software : you can redistribute it and /or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see < http://www.gnu.org/licenses/>.
+#pragma once
+#include <string>
+
+#include "defines.hpp"
+
+/**
+ * Hot paths tagged with CPU_DISPATCH are compiled once per instruction set level and the loader
+ * picks the best clone for the running cpu, so a single binary uses popcnt, tzcnt and friends
+ * without requiring them. Only GCC on x86-64 supports the clones, elsewhere the tag is empty and
+ * the code is built for whatever the compiler flags target. */
+#if defined(ENABLE_CPU_DISPATCH) && defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define CPU_DISPATCH_ACTIVE
+#if defined(__BMI2__)
+// a v2 clone would drop the BMI2 the default target already has, i.e. pext with USE_PEXT.
+#define CPU_DISPATCH __attribute__((target_clones("arch=x86-64-v3", "default")))
+#else
+#define CPU_DISPATCH __attribute__((target_clones("arch=x86-64-v3", "arch=x86-64-v2", "default")))
+#endif
+#else
+#define CPU_DISPATCH
+#endif
+
+namespace cpu {
+
+/**
+ * @brief Instruction set levels hot paths can be built for, ordered from least to most capable.
+ * v2 adds popcnt, v3 adds BMI1/BMI2 and AVX2 on top of it.  */
+enum class Level : u8 {
+    Baseline,
+    Popcnt,
+    Avx2
+};
+
+struct Features {
+    bool popcnt = false;
+    bool bmi2 = false;
+    bool avx2 = false;
+};
+
+/**
+ * @brief Queries cpuid for the features the engine cares about.  */
+Features detect();
+
+/**
+ * @brief Highest level the given cpu runs, matching the clone the loader resolves to.  */
+Level bestLevel(const Features& features);
+
+/**
+ * @brief Level the hot paths of this binary actually run with. Without runtime dispatch this is
+ * the level the compiler targeted.  */
+Level activeLevel();
+
+const char* toString(Level level);
+
+/**
+ * @brief One line summary of detected features and chosen path, i.e. "popcnt bmi2 avx2, path x86-64-v3 (dispatch)".  */
+std::string describe();
+
+}  // namespace cpu
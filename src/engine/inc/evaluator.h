@@ -14,6 +14,11 @@ class Evaluator
 public:
     Evaluator();
     i32 Evaluate(const Chessboard& board, const MoveGenerator& movegen);
+
+    /**
+     * @brief Evaluates the position from the perspective of us, i.e. positive is good for the side to move.  */
+    template<Set us>
+    i32 Evaluate(const Chessboard& board, const MoveGenerator& movegen);
     i32 EvaluatePlus(const Chessboard& board, const MoveGenerator& movegen, PackedMove move);
 
 private:
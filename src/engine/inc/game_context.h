@@ -14,24 +14,40 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.If not, see < http://www.gnu.org/licenses/>.
 #pragma once
+#include <memory>
 #include <vector>
 #include "chessboard.h"
 #include "transposition_table.hpp"
 
+class Search;
 struct SearchResult;
 struct SearchParameters;
 
+// frames allocated up front, enough for a long game plus the deepest search line. Only games
+// longer than this grow the stack, through ReserveStates, which searches call before they start.
+static constexpr u32 c_stateStackSize = 1024;
+
+/**
+ * @brief One frame of the per ply state stack. Holds the undo information of the move which led
+ * to the position and the king safety of the side to move, computed once when the move is made.  */
+struct StateInfo {
+    MoveUndoUnit undo;
+    // opponent pieces giving check to the side to move.
+    Bitboard checkers;
+    // opponent sliders pinning a piece of the side to move to its king, and the pinned pieces.
+    Bitboard pinners;
+    Bitboard pinned;
+#if defined(ENABLE_COPY_MAKE)
+    // the board before the move, unmake copies it back instead of replaying the move in reverse.
+    BoardSnapshot board;
+#endif
+};
+
 class GameContext {
 public:
-    GameContext() {
-        m_transpositionTable.resize(64);
-        Reset();
-    }
-
-    GameContext(const GameContext& rhs) :
-        m_board(rhs.m_board)
-    {
-    }
+    GameContext();
+    GameContext(const GameContext& rhs);
+    ~GameContext();
 
     void Reset();
     void NewGame();
@@ -42,15 +58,59 @@ public:
     bool TryMakeMove(Move move);
 
     /**
-     * @brief Makes a move on the board, assumes move is legal. */
+     * @brief Makes a move on the board, assumes move is legal. Never grows the state stack, the
+     * frame for the move has to be reserved already.  */
     bool MakeMove(const PackedMove move);
     bool UnmakeMove();
 
+    /**
+     * @brief State of the current ply, the root frame has no undo information.  */
+    const StateInfo& readState() const { return m_states[m_stateIndex]; }
+
+    /**
+     * @brief Grows the state stack so plies more moves fit on top of the current one. Called
+     * before a search or a game move, so frames never move while a search holds on to them.  */
+    void ReserveStates(u32 plies);
+
+    /**
+     * @brief Recomputes the derived state of the current ply, needed after the board has been
+     * edited directly rather than through MakeMove.  */
+    void RefreshState();
+
+    /**
+     * @brief Searches for the best move with the search state kept from earlier moves of the game,
+     * killers and history are only wiped by ClearSearch.  */
     SearchResult CalculateBestMove(SearchParameters params);
 
+    /**
+     * @brief Forgets the move ordering learned during the game, i.e. on ucinewgame.  */
+    void ClearSearch();
+
+    /**
+     * @brief Checks if the game has ended in checkmate, stalemate, threefold repetition,
+     * the fifty move rule or insufficient material.  */
     bool GameOver() const;
+
+    /**
+     * @brief Fifty moves, i.e. a hundred plies, without a capture or pawn move.  */
+    bool IsFiftyMoveRule() const { return m_board.readPlyCount() >= 100; }
+
+    /**
+     * @brief The fifty move rule applies unless the move which ran out the clock delivered
+     * checkmate, in which case the mate stands.  */
+    bool IsFiftyMoveDraw() const;
+
+    /**
+     * @brief Checks if hashKey has occured twice before, only positions since the last capture
+     * or pawn move with the same side to move are scanned.  */
     bool IsRepetition(u64 hashKey) const;
 
+    /**
+     * @brief Checks if the side to move can repeat a position with a single reversible move.
+     * searchPly counts from 1 at the root like the search does, only positions strictly after the
+     * root, i.e. inside the search tree, are considered. */
+    bool HasUpcomingRepetition(u32 searchPly) const;
+
     /**
      * @brief Checks if the game is over.    */
     bool isGameOver() const;
@@ -64,11 +124,20 @@ public:
 
     Set readToPlay() const { return m_board.readToPlay(); }
 
-    TranspositionTable& editTranspositionTable() { return m_transpositionTable; }
+    TranspositionTable& editTranspositionTable() { return *m_transpositionTable; }
+    /**
+     * @brief Searches use table instead of a table of their own, e.g. games searched in parallel
+     * sharing one. The own table is released, table has to outlive the context.  */
+    void shareTranspositionTable(TranspositionTable& table);
+    const Search& readSearch() const { return *m_search; }
 
 private:
     Chessboard m_board;
-    TranspositionTable m_transpositionTable;
+    std::unique_ptr<TranspositionTable> m_ownTable;
+    TranspositionTable* m_transpositionTable;
+    std::unique_ptr<Search> m_search;
 
-    std::vector<MoveUndoUnit> m_undoUnits;
+    // frame 0 is the position set up on the board, frame n the one after the n:th move.
+    std::vector<StateInfo> m_states;
+    u32 m_stateIndex = 0;
 };
\ No newline at end of file
@@ -30,20 +30,30 @@ struct ZorbistHash
     u64 HashEnPassant(const u64& oldHash, Notation position) const;
     u64 HashCastling(const u64& oldHash, const u8 castlingState) const;
     u64 HashBlackToMove(const u64& oldHash) const;
-    
+
+    /**
+     * @brief Looks up the reversible piece move which changes a hash by hashDiff, including the
+     * side to move flip. Used to detect if the side to move can repeat an earlier position.
+     * @return true if a move was found, source and target are written to src and trg.  */
+    bool CuckooLookup(u64 hashDiff, u8& src, u8& trg) const;
+
 private:
 
-    void GenerateZorbistTable();
-    ZorbistHash()
-        : initialized(false)
-    {
-        GenerateZorbistTable();
-    }
-    static ZorbistHash instance;
-
-    bool initialized;
-    u64 table[64][12];
-    u64 black_to_move;
-    u64 castling[4];
-    u64 enpassant[8];
+    constexpr void GenerateZorbistTable();
+    constexpr void GenerateCuckooTable();
+    static constexpr u32 CuckooH1(u64 hash) { return hash & 0x1fff; }
+    static constexpr u32 CuckooH2(u64 hash) { return (hash >> 16) & 0x1fff; }
+
+    // only constructed at compile time, the instance lives in read only memory.
+    constexpr ZorbistHash();
+    static const ZorbistHash instance;
+
+    u64 table[64][12]{};
+    u64 black_to_move{};
+    u64 castling[4]{};
+    u64 enpassant[8]{};
+
+    // cuckoo tables, 3668 reversible moves for non pawn pieces fit in 8192 slots.
+    u64 cuckoo[8192]{};
+    u16 cuckooMoves[8192]{};
 };
\ No newline at end of file
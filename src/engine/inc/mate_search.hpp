@@ -0,0 +1,114 @@
+// Elephant Gambit Chess Engine - a Chess AI
+// Copyright(C) 2021-2024  Alexander Loodin Ek
+
+// This program is free software : you can redistribute it and /or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see < http://www.gnu.org/licenses/>.
+#pragma once
+#include <atomic>
+#include <vector>
+
+#include "defines.hpp"
+#include "move.h"
+#include "time_manager.hpp"
+
+class GameContext;
+struct SearchParameters;
+
+namespace mate_search_constants {
+// proof and disproof numbers saturate at this value, a node with a number at infinity is solved.
+constexpr u32 infinity = 1u << 30;
+constexpr u32 defaultTableSizeMb = 16;
+// upper bound on legal moves in any chess position.
+constexpr u32 maxMoves = 256;
+// amount of stop checks between polling the clock, keep it a power of two.
+constexpr u32 pollInterval = 1024;
+}  // namespace mate_search_constants
+
+struct MateSearchResult {
+    PackedMove move = PackedMove::NullMove();
+    // length of the forced mate in moves, 0 if no mate was found.
+    u32 mateIn = 0;
+    u64 nodes = 0;
+};
+
+/**
+ * @brief Depth first proof-number solver for forced mates. The side to move attacks and is only
+ * allowed checking moves, the defender gets every legal reply. Nodes are stored in a compact always
+ * replace table keyed on hash and remaining plies, so the same position with a different amount of
+ * moves left is a different node.  */
+class MateSearch {
+public:
+    explicit MateSearch(u32 tableSizeMb = mate_search_constants::defaultTableSizeMb);
+
+    /**
+     * @brief Searches for a forced mate in at most params.MateIn moves, mate lengths are tried in
+     * increasing order so the first mate found is the shortest one. Node and time limits of params
+     * are respected.  */
+    MateSearchResult Solve(GameContext& context, const SearchParameters& params);
+
+    /**
+     * @brief Requests a running solve to stop as soon as possible, safe to call from another thread.  */
+    void stop() { m_stop.store(true, std::memory_order_relaxed); }
+
+    void clear();
+
+private:
+    struct Entry {
+        u64 key = 0;
+        u32 proof = 1;
+        u32 disproof = 1;
+    };
+    static_assert(sizeof(Entry) == 16, "mate search entries are expected to be 16 bytes");
+
+    struct Child {
+        u64 key;
+        PackedMove move;
+    };
+
+    /**
+     * @brief Multiple iterative deepening, searches the current node until its proof or disproof
+     * number reaches the given threshold.
+     * @param remaining plies left until the attacker has to have delivered mate.  */
+    void MID(GameContext& context, u32 remaining, u32 proofThreshold, u32 disproofThreshold, bool attacker);
+
+    u32 generateChildren(GameContext& context, u32 remaining, bool attacker, Child* children, bool& inCheck);
+
+    const Entry& probe(u64 key) const;
+    void store(u64 key, u32 proof, u32 disproof);
+    static u64 buildKey(u64 hash, u32 remaining) { return hash ^ (remaining * 0x9E3779B97F4A7C15ull); }
+
+    inline bool isStopped()
+    {
+        if (m_nodeLimit > 0 && m_nodes >= m_nodeLimit)
+            stop();
+        else if (--m_pollCountdown == 0) {
+            m_pollCountdown = mate_search_constants::pollInterval;
+            if (m_timeManager.hardLimitReached())
+                stop();
+        }
+        return m_stop.load(std::memory_order_relaxed);
+    }
+
+    std::vector<Entry> m_table;
+    u64 m_mask = 0;
+
+    std::atomic<bool> m_stop = false;
+    u32 m_pollCountdown = mate_search_constants::pollInterval;
+    TimeManager m_timeManager;
+    u64 m_nodeLimit = 0;
+    u64 m_nodes = 0;
+
+    // the root is the only node with this many plies remaining, its proving move is recorded here.
+    u32 m_rootRemaining = 0;
+    PackedMove m_rootMove = PackedMove::NullMove();
+};
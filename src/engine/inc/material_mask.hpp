@@ -22,75 +22,40 @@ struct MaterialMask {
     [[nodiscard]] constexpr const Bitboard& pawns() const { return material[pawnId]; }
 };
 
-struct MutableMaterialProxy;
-
-struct MutableMaterialProxySquare {
-public:
-    MutableMaterialProxySquare(u64& proxyMaterial, u64& proxySet, Square sqr) : m_setProxy(proxySet), m_matProxy(proxyMaterial), m_sqr(sqr) {}
-
-    void operator=(bool value) {
-        m_setProxy[m_sqr] = value;
-        m_matProxy[m_sqr] = value;
-    }
-
-private:
-    BitboardImpl<u64&> m_setProxy;
-    BitboardImpl<u64&> m_matProxy;
-    Square m_sqr;
-};
-
-struct MutableMaterialProxy {
-public:
-    MutableMaterialProxy(Bitboard* set, Bitboard* material) : m_set(set), m_material(material) {}
-    MutableMaterialProxy(const MutableMaterialProxy& other) : m_set(other.m_set), m_material(other.m_material) {}
-
-    MutableMaterialProxy& operator=(MutableMaterialProxy other) {
-        if (this != &other) {
-            std::swap(m_set, other.m_set);
-            std::swap(m_material, other.m_material);
-        }
-        return *this;
-    };
-
-    constexpr bool operator[](Square sqr) const {
-        // extract bit in each board individually to verify they are the same
-        bool setMask = (*m_set & squareMaskTable[static_cast<u8>(sqr)]) != 0;
-        bool matMask = (*m_material & squareMaskTable[static_cast<u8>(sqr)]) != 0;
-
-        FATAL_ASSERT(setMask == matMask) << "Inconsistent Bitboards, these values should be the same, terminating program.";
-        return setMask && matMask;
-    }
-
-    MutableMaterialProxySquare operator[](Square sqr) {
-        return MutableMaterialProxySquare(m_set->edit(), m_material->edit(), sqr);
-    }
-
-private:
-    Bitboard* m_set;
-    Bitboard* m_material;
-};
-
 // this would be 8 x 64bits, i.e. 64 bytes per position rather than the currently used
 // 12 x 64bits, i.e. 96 bytes per position.
+// the union of both sets is cached in m_occupancy since nearly every slider lookup needs it,
+// every writer has to keep it in sync.
 struct MaterialPositionMask {
     friend class Position;
 private:
     Bitboard m_set[2];
     Bitboard m_material[6];
+    Bitboard m_occupancy;
 public:
     bool empty() const;
 
+    /**
+     * @brief Moves a piece by toggling both its source and target square, fromTo is expected
+     * to hold exactly those two squares and the target square to be empty.  */
+    void move(Bitboard fromTo, Set set, i8 pieceId)
+    {
+        m_set[static_cast<i8>(set)] ^= fromTo;
+        m_material[pieceId] ^= fromTo;
+        m_occupancy ^= fromTo;
+    }
+
     void write(Bitboard mask, Set set, i8 pieceId);
     template<Set us> void write(Bitboard mask, i32 pieceId);
     template<Set us, i32 pieceId> void write(Bitboard mask);
 
-    [[nodiscard]] Bitboard read(i32 pieceId) const;
-    [[nodiscard]] Bitboard read(Set set, i8 pieceId) const;
+    [[nodiscard]] Bitboard read(i32 pieceId) const { return m_material[pieceId]; }
+    [[nodiscard]] Bitboard read(Set set, i8 pieceId) const { return m_material[pieceId] & m_set[static_cast<i8>(set)]; }
     template<Set us, i32 pieceId> [[nodiscard]] Bitboard read() const;
     template<Set us> [[nodiscard]] Bitboard read(i8 pieceId) const;
 
-    [[nodiscard]] const Bitboard combine() const;
-    [[nodiscard]] const Bitboard combine(Set set) const;
+    [[nodiscard]] Bitboard combine() const { return m_occupancy; }
+    [[nodiscard]] Bitboard combine(Set set) const { return m_set[static_cast<i8>(set)]; }
     template<Set us> [[nodiscard]] constexpr Bitboard combine() const;
 
     void clear();
@@ -147,6 +112,7 @@ void MaterialPositionMask::write(Bitboard mask, i32 pieceId)
     }
 
     m_material[pieceId] |= mask;
+    m_occupancy |= mask;
 }
 
 template<Set us, i32 pieceId>
@@ -181,6 +147,7 @@ void MaterialPositionMask::clear(Bitboard mask)
     for (i32 i = 0; i < 6; i++) {
         m_material[i] &= ~mask;
     }
+    m_occupancy &= ~mask;
 }
 
 template<Set us>
@@ -193,6 +160,7 @@ void MaterialPositionMask::clear(Bitboard mask, i32 pieceId)
         m_set[1] &= ~mask;
     }
     m_material[pieceId] &= ~mask;
+    m_occupancy &= ~mask;
 }
 
 template<Set us, i32 pieceId>
@@ -17,7 +17,10 @@
 #define MOVE_GENERATOR_HEADER
 
 #include <queue>
+#include "attack_maps.hpp"
+#include "cpu.hpp"
 #include "king_pin_threats.hpp"
+#include "move_list.hpp"
 #include "transposition_table.hpp"
 #include "move.h"
 #include "position.hpp"
@@ -45,53 +48,126 @@ class MoveGenerator {
 public:
     MoveGenerator(const GameContext& context);
     MoveGenerator(const GameContext& context, const TranspositionTable& tt, const Search& search, u32 ply);
+    /**
+     * @brief Generator restricted to mtype for the position the search reached, checkers and
+     * pins of the side to move are taken from the state of the ply.  */
+    MoveGenerator(const GameContext& context, MoveTypes mtype);
     MoveGenerator(const Position& pos, Set toMove, PieceType ptype = PieceType::NONE, MoveTypes mtype = MoveTypes::ALL);
-    ~MoveGenerator() = default;
+    ~MoveGenerator();
+
+    // the move list is a slot of the arena for the current ply, it can't be shared or handed over.
+    MoveGenerator(const MoveGenerator&) = delete;
+    MoveGenerator& operator=(const MoveGenerator&) = delete;
 
     PrioratizedMove generateNextMove();
-    void forEachMove(std::function<void(const PrioratizedMove&)> func) const;
     void generate();
 
+    /**
+     * @brief Calls func with every generated move. The visitor is a template parameter so it's
+     * inlined into the loop, nothing is type erased or allocated per call.  */
+    template<typename Visitor>
+    void forEachMove(Visitor&& func) const;
+
+    /**
+     * @brief Range over the generated moves, i.e. for (const PrioratizedMove& move : generator),
+     * in the order they were generated. Requires generate() to have been called.  */
+    const PrioratizedMove* begin() const { return m_moves.begin(); }
+    const PrioratizedMove* end() const { return m_moves.end(); }
+
+    /**
+     * @brief Side to move resolved at compile time, used by the search which already knows
+     * whose turn it is and shouldn't pay for branching on it at every node.  */
+    template<Set set>
+    PrioratizedMove generateNextMove();
+
     bool isChecked() const;
+    template<Set us>
+    bool isChecked() const;
+
+    /**
+     * @brief Opponent pieces giving check to the king of us.  */
+    template<Set us>
+    Bitboard readCheckers() const;
+    /**
+     * @brief Opponent sliders pinning a piece of us to its king.  */
+    template<Set us>
+    Bitboard readPinners() const;
 
+    /**
+     * @brief Per angle breakdown of the checks and pins, built on first use. Move generation
+     * only needs the checkers and pinned pieces above, so this is computed on every call.  */
     template<Set us>
-    const KingPinThreats& readKingPinThreats() const;
+    KingPinThreats readKingPinThreats() const;
+
+    /**
+     * @brief Attack maps of the position, shared with the exchange evaluation of quiescence.  */
+    const AttackMaps& readAttackMaps() const { return m_attackMaps; }
 
 private:
     void initializeMoveGenerator(PieceType ptype, MoveTypes mtype);
+    void initializeFromState(const GameContext& context);
 
     template<Set set, bool captures>
-    void initializeMoveMasks(MaterialMask& target, PieceType ptype);
+    void initializeMoveMasks(PieceType ptype);
 
+    /**
+     * @brief Squares the pieces of set may move to before per piece restrictions, i.e. not
+     * occupied by our own pieces, restricted to captures and to blocking or capturing a checker.  */
     template<Set set>
-    PrioratizedMove generateNextMove();
+    Bitboard calcTargetMask() const;
+
+    /**
+     * @brief Ray from our king through the pinned piece on sqr to its pinner, empty if the
+     * piece isn't pinned.  */
+    template<Set set>
+    Bitboard calcPinRay(u8 sqr) const;
+
+    /**
+     * @brief En passant can expose our king along the rank, or fail to resolve a check, so it
+     * is verified by looking at the attacks on our king with the board as it would be after it.  */
+    template<Set set>
+    bool isLegalEnPassant(u8 srcSqr) const;
+
+    template<Set set>
+    void calcKingSafety() const;
 
     template<Set set>
     void generateAllMoves();
 
+    /**
+     * @brief Moves out of check. Besides the king only the checker and the squares between it and
+     * our king are looked at, and for each of them the pieces able to get there.  */
+    template<Set set>
+    CPU_DISPATCH void generateEvasions();
+
     template<Set set, u8 pieceId>
-    void generateMoves(const KingPinThreats& pinThreats);
+    void generateMoves();
 
-    template<Set set>
-    void internalGenerateMoves(u8 pieceId, const KingPinThreats& pinThreats);
+    template<Set set, u8 pieceId>
+    CPU_DISPATCH void internalGenerateMoves();
 
     template<Set set>
-    void internalGeneratePawnMoves(const KingPinThreats& pinThreats);
-    void internalBuildPawnPromotionMoves(PackedMove move, const KingPinThreats& pinThreats, i32 dstSqr);
+    CPU_DISPATCH void internalGeneratePawnMoves();
+    template<Set set>
+    void internalBuildPawnMove(PackedMove move, i32 dstSqr);
+    void internalBuildPawnPromotionMoves(PackedMove move);
     template<Set set>
-    void internalGenerateKnightMoves(const KingPinThreats& pinThreats);
+    void internalGenerateKnightMoves();
     template<Set set>
-    void internalGenerateBishopMoves(const KingPinThreats& pinThreats);
+    void internalGenerateBishopMoves();
     template<Set set>
-    void internalGenerateRookMoves(const KingPinThreats& pinThreats);
+    void internalGenerateRookMoves();
     template<Set set>
-    void internalGenerateQueenMoves(const KingPinThreats& pinThreats);
+    void internalGenerateQueenMoves();
     template<Set set>
-    void internalGenerateKingMoves();
+    CPU_DISPATCH void internalGenerateKingMoves();
 
-    void genPackedMovesFromBitboard(u8 setId, u8 pieceId, Bitboard movesbb, i32 srcSqr, bool capture, const KingPinThreats& pinThreats);
+    CPU_DISPATCH void genPackedMovesFromBitboard(u8 pieceId, Bitboard movesbb, i32 srcSqr, bool capture);
 
-    void sortMoves();
+    /**
+     * @brief Boosts the transposition table move, killers and history on top of the priorities
+     * given while generating. Ordering itself is left to the picker.  */
+    void scoreMoves();
 
     Set m_toMove;
     const Position& m_position;
@@ -100,35 +176,49 @@ private:
     const u32 m_ply;
     u64 m_hashKey;
 
+    PieceType m_pieceType;
+    MoveTypes m_moveTypes;
     bool m_movesGenerated;
-    uint16_t m_moveCount;
-    uint16_t m_currentMoveIndx;
-    std::array<PrioratizedMove, 256> m_movesBuffer;  // 1kb
+    // depth of our slot in the move arena, released again by the destructor.
+    u32 m_arenaSlot;
+    MoveList m_moves;
+    MovePicker m_picker;
+
+    // legal king moves of the side to move, every other piece is generated square by square.
+    Bitboard m_kingMoves;
+
+    // checkers, pinners and pinned per side. The side to move is taken from the per ply state
+    // when the search created us, the other side is only computed if something asks for it.
+    mutable bool m_kingSafetyComputed[2];
+    mutable Bitboard m_checkers[2];
+    mutable Bitboard m_pinners[2];
+    mutable Bitboard m_pinned[2];
+
+    // check squares and discovered check candidates of the side to move.
+    CheckInfo m_checkInfo;
 
-    // pseudo legal move masks for each piece type
-    MaterialMask m_moveMasks[2];
-    KingPinThreats m_pinThreats[2];
+    AttackMaps m_attackMaps;
 };
 
 template<Set set, u8 pieceId>
 void
-MoveGenerator::generateMoves(const KingPinThreats& pinThreats)
+MoveGenerator::generateMoves()
 {
     switch (pieceId) {
         case pawnId:
-            internalGeneratePawnMoves<set>(pinThreats);
+            internalGeneratePawnMoves<set>();
             break;
         case knightId:
-            internalGenerateKnightMoves<set>(pinThreats);
+            internalGenerateKnightMoves<set>();
             break;
         case bishopId:
-            internalGenerateBishopMoves<set>(pinThreats);
+            internalGenerateBishopMoves<set>();
             break;
         case rookId:
-            internalGenerateRookMoves<set>(pinThreats);
+            internalGenerateRookMoves<set>();
             break;
         case queenId:
-            internalGenerateQueenMoves<set>(pinThreats);
+            internalGenerateQueenMoves<set>();
             break;
         case kingId:
             internalGenerateKingMoves<set>();
@@ -139,11 +229,40 @@ MoveGenerator::generateMoves(const KingPinThreats& pinThreats)
     }
 }
 
+template<typename Visitor>
+void MoveGenerator::forEachMove(Visitor&& func) const
+{
+    if (m_movesGenerated == false)
+        LOG_ERROR() << "Moves have not been generated yet.";
+
+    for (const PrioratizedMove& move : m_moves)
+        func(move);
+}
+
+template<Set us>
+bool MoveGenerator::isChecked() const
+{
+    return readCheckers<us>().empty() == false;
+}
+
+template<Set us>
+Bitboard MoveGenerator::readCheckers() const
+{
+    calcKingSafety<us>();
+    return m_checkers[static_cast<u8>(us)];
+}
+
+template<Set us>
+Bitboard MoveGenerator::readPinners() const
+{
+    calcKingSafety<us>();
+    return m_pinners[static_cast<u8>(us)];
+}
 
 template<Set us>
-const KingPinThreats& MoveGenerator::readKingPinThreats() const
+KingPinThreats MoveGenerator::readKingPinThreats() const
 {
-    return m_pinThreats[static_cast<u8>(us)];
+    return m_position.calcKingMask<us>();
 }
 
 #endif  // MOVE_GENERATOR_HEADER
\ No newline at end of file
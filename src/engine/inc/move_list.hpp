@@ -0,0 +1,123 @@
+// Elephant Gambit Chess Engine - a Chess AI
+// Copyright(C) 2021-2024  Alexander Loodin Ek
+
+// This program is free software : you can redistribute it and /or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see < http://www.gnu.org/licenses/>.
+#pragma once
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "defines.hpp"
+#include "log.h"
+#include "move.h"
+
+namespace move_list_constants {
+// no legal chess position has more than 218 moves.
+constexpr u16 capacity = 256;
+// slots created up front, enough for a full search and quiescence line. Deeper nesting grows
+// the arena the first time it happens.
+constexpr u16 preallocatedSlots = 64;
+}  // namespace move_list_constants
+
+/**
+ * @brief Moves of a single node written into storage owned by someone else, usually a slot of
+ * the MoveArena. Only the moves pushed are ever written, nothing is cleared up front.  */
+class MoveList {
+public:
+    MoveList() = default;
+    explicit MoveList(PrioratizedMove* storage) :
+        m_moves(storage),
+        m_size(0)
+    {}
+
+    void push(PrioratizedMove move) { m_moves[m_size++] = move; }
+    void clear() { m_size = 0; }
+
+    [[nodiscard]] u16 size() const { return m_size; }
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    PrioratizedMove& operator[](u16 indx) { return m_moves[indx]; }
+    const PrioratizedMove& operator[](u16 indx) const { return m_moves[indx]; }
+
+    PrioratizedMove* begin() { return m_moves; }
+    PrioratizedMove* end() { return m_moves + m_size; }
+    const PrioratizedMove* begin() const { return m_moves; }
+    const PrioratizedMove* end() const { return m_moves + m_size; }
+
+private:
+    PrioratizedMove* m_moves = nullptr;
+    u16 m_size = 0;
+};
+
+/**
+ * @brief Per thread stack of move buffers. Move generators are created and destroyed in strict
+ * nesting order as the search walks down and back up the tree, so the slot handed out is the one
+ * of the current nesting depth, i.e. the ply, and it's reused by every node at that depth.  */
+class MoveArena {
+public:
+    using Slot = std::array<PrioratizedMove, move_list_constants::capacity>;
+
+    MoveArena();
+
+    /**
+     * @brief Arena of the calling thread.  */
+    static MoveArena& local();
+
+    [[nodiscard]] PrioratizedMove* acquire();
+    /**
+     * @brief Hands back the slot acquired at depth, which has to be the most recent one still in
+     * use. Releasing out of order would let two live generators write the same slot.  */
+    void release(u32 depth)
+    {
+        FATAL_ASSERT(depth + 1 == m_depth) << "Move arena slot " << depth << " released while " << m_depth << " are in use";
+        m_depth = depth;
+    }
+
+    [[nodiscard]] u32 depth() const { return m_depth; }
+
+private:
+    // slots are allocated separately so growing the arena never moves a list still in use.
+    std::vector<std::unique_ptr<Slot>> m_slots;
+    u32 m_depth;
+};
+
+/**
+ * @brief Hands out the moves of a list best priority first. Instead of sorting everything up
+ * front the best remaining move is swapped to the front when it's asked for, nodes which cut
+ * off after a move or two never pay for ordering the rest.  */
+class MovePicker {
+public:
+    MovePicker() = default;
+
+    [[nodiscard]] bool done(const MoveList& moves) const { return m_next >= moves.size(); }
+
+    PrioratizedMove next(MoveList& moves)
+    {
+        const u16 size = moves.size();
+        u16 best = m_next;
+        for (u16 indx = m_next + 1; indx < size; ++indx) {
+            if (moves[indx].priority > moves[best].priority)
+                best = indx;
+        }
+
+        const PrioratizedMove result = moves[best];
+        moves[best] = moves[m_next];
+        moves[m_next] = result;
+        ++m_next;
+        return result;
+    }
+
+private:
+    u16 m_next = 0;
+};
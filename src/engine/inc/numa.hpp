@@ -0,0 +1,85 @@
+// Elephant Gambit Chess Engine - a Chess AI
+// Copyright(C) 2021-2024  Alexander Loodin Ek
+
+// This program is free software : you can redistribute it and /or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see < http://www.gnu.org/licenses/>.
+#pragma once
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "defines.hpp"
+
+namespace numa {
+
+/**
+ * @brief How parallelFill splits the initial fill of a large table between its threads. Linux
+ * places a page on the node of the thread which first writes to it, the threads are bound with
+ * bindThread, i.e. spread round robin over the nodes. With a single thread, or a single node,
+ * every page ends up on the node of the caller whatever the placement.  */
+enum class Placement : u8 {
+    // thread i fills the i:th of one contiguous slice per thread. Slices land on the node of the
+    // thread that filled them, with more threads than nodes a node holds several slices.
+    FirstTouch,
+    // chunks of c_interleaveChunkSize are handed out to the threads round robin, so consecutive
+    // chunks belong to threads bound to different nodes.
+    Interleave
+};
+
+// granularity of interleaved placement, a multiple of both regular and huge pages.
+constexpr size_t c_interleaveChunkSize = 2 * 1024 * 1024;
+
+struct Node {
+    u32 id = 0;
+    std::vector<u32> cpus;
+};
+
+/**
+ * @brief Parses a kernel cpu list such as "0-3,8,10-11".  */
+std::vector<u32> parseCpuList(const std::string& cpuList);
+
+/**
+ * @brief Memory nodes and their cpus read from sysfs, without depending on libnuma. Machines
+ * without the sysfs node directory are treated as a single node holding every cpu.  */
+class Topology {
+public:
+    static const Topology& Instance();
+
+    /**
+     * @brief Reads the topology from a sysfs style node directory, i.e. /sys/devices/system/node.  */
+    explicit Topology(const std::string& nodeDirectory);
+
+    const std::vector<Node>& readNodes() const { return m_nodes; }
+    u32 readNodeCount() const { return static_cast<u32>(m_nodes.size()); }
+    u32 readCpuCount() const;
+
+    /**
+     * @brief Threads are spread round robin over the nodes, and over the cpus within a node.  */
+    const Node& nodeForThread(u32 threadIndex) const;
+    u32 cpuForThread(u32 threadIndex) const;
+
+private:
+    std::vector<Node> m_nodes;
+};
+
+/**
+ * @brief Pins the calling thread to the cpu picked by Topology::cpuForThread, returns false if
+ * binding isn't supported or failed.  */
+bool bindThread(u32 threadIndex);
+
+/**
+ * @brief Zeroes memory with the given number of threads bound with bindThread, split between them
+ * according to placement. A single thread simply clears the memory on the caller, without binding.  */
+void parallelFill(void* data, size_t bytes, u32 threads, Placement placement);
+
+}  // namespace numa
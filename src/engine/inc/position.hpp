@@ -30,9 +30,11 @@
 #include "defines.hpp"
 #include "intrinsics.hpp"
 #include "king_pin_threats.hpp"
+#include "move.h"
 #include "notation.h"
 #include "material_mask.hpp"
 
+class AttackMaps;
 struct Notation;
 
 
@@ -147,9 +149,22 @@ private:
     byte m_innerState;
 };
 
+/**
+ * @brief What a side needs to tell whether a move checks the opponent king without making it.
+ * Built once per position with Position::calcCheckInfo.  */
+struct CheckInfo {
+    // squares each of our piece types would attack the opponent king from, indexed by piece id.
+    Bitboard checkSquares[6];
+    // our pieces standing between one of our sliders and the opponent king.
+    Bitboard discoverers;
+    // NullSQ when the opponent has no king.
+    Square kingSqr = Square::NullSQ;
+};
+
 /**
  * A chess position, represented as a set of bitboards and some bytes of additional state.
  * 64 bytes of material information, by using 2 boards for set and 6 for pieces
+ * 64 bytes mailbox holding the piece of each square
  * 1 byte of castling information.
  * 1 byte for enpassant information.
  * 7 bits for halfmoves // no point in tracking it past 100
@@ -162,7 +177,6 @@ public:
 
 public:
     Position();
-    Position& operator=(const Position& other);
 
     /* Material Manpulators and readers */
 
@@ -172,10 +186,19 @@ public:
     bool PlacePiece(ChessPiece piece, Square target);
     bool ClearPiece(ChessPiece piece, Square target);
 
-    ChessPiece readPieceAt(Square sqr) const;
-    const MaterialPositionMask& readMaterial() const { return m_materialMask; }
+    /**
+     * @brief Moves piece from source to an empty target square with a single xor per board,
+     * used by make and unmake instead of a clear followed by a place.  */
+    void MovePiece(ChessPiece piece, Square source, Square target)
+    {
+        const Bitboard fromTo(squareMaskTable[static_cast<u8>(source)] | squareMaskTable[static_cast<u8>(target)]);
+        m_materialMask.move(fromTo, piece.getSet(), piece.index());
+        m_mailbox[static_cast<u8>(source)] = ChessPiece::None();
+        m_mailbox[static_cast<u8>(target)] = piece;
+    }
 
-    MutableMaterialProxy materialEditor(Set set, PieceType pType);
+    ChessPiece readPieceAt(Square sqr) const { return m_mailbox[static_cast<u8>(sqr)]; }
+    const MaterialPositionMask& readMaterial() const { return m_materialMask; }
 
     EnPassantStateInfo& editEnPassant() { return m_enpassantState; }
     EnPassantStateInfo readEnPassant() const { return m_enpassantState; }
@@ -196,6 +219,10 @@ public:
     Bitboard calcAvailableMovesQueenBulk(const KingPinThreats& kingPinThreats) const;
     template<Set us, bool captures = false, Set op = opposing_set<us>()>
     Bitboard calcAvailableMovesKing(byte castlingRights) const;
+    /**
+     * @brief King moves given the squares threatened by the opponent, looking through our king.  */
+    template<Set us, bool captures = false, Set op = opposing_set<us>()>
+    Bitboard calcAvailableMovesKing(byte castlingRights, Bitboard threatened) const;
 
     template<Set us>
     Bitboard calcThreatenedSquaresPawnBulk() const;
@@ -229,6 +256,52 @@ public:
     template<Set us>
     KingPinThreats calcKingMask() const;
 
+    /**
+     * @brief Pieces of both sets attacking sqr given occupancy, occupancy is passed in so
+     * x-ray attackers can be revealed while resolving an exchange.  */
+    Bitboard calcAttackersTo(Square sqr, Bitboard occupancy) const;
+
+    /**
+     * @brief Opponent pieces checking the king of set, opponent sliders pinning a piece of set
+     * to its king and the pinned pieces, in that order. All empty if set has no king.  */
+    std::tuple<Bitboard, Bitboard, Bitboard> calcCheckersAndPins(Set set) const;
+
+    template<Set us>
+    CheckInfo calcCheckInfo() const;
+
+    /**
+     * @brief Move could have been generated for us in this position if we disregard our king
+     * being left in check, i.e. a move from the transposition table or a killer slot which may
+     * belong to a different position.  */
+    template<Set us>
+    bool isPseudoLegal(PackedMove move) const;
+
+    /**
+     * @brief Pseudo legal move doesn't leave our king in check.  */
+    template<Set us>
+    bool isLegal(PackedMove move) const;
+
+    /**
+     * @brief Pseudo legal move checks the opponent king, directly, by uncovering one of our
+     * sliders, or through the rook of a castling move.  */
+    bool givesCheck(PackedMove move, const CheckInfo& checkInfo) const;
+
+    /**
+     * @brief Neither side has enough material left to deliver checkmate, i.e. bare kings, a
+     * single minor piece or only bishops all standing on the same colored squares.  */
+    bool isInsufficientMaterial() const;
+
+    /**
+     * @brief Static exchange evaluation of the capture sequence on target initiated by the
+     * piece standing on source. Both sides always recapture with their least valuable attacker
+     * and may stop when continuing would lose material.
+     * @return material gain in centipawns for the side moving from source.  */
+    i32 calcStaticExchangeEvaluation(Square source, Square target) const;
+    /**
+     * @brief Same as above, but skips the exchange when the attack maps already show the
+     * opponent can't recapture on target.  */
+    i32 calcStaticExchangeEvaluation(Square source, Square target, const AttackMaps& attackMaps) const;
+
 private:
     template<Set us, u8 direction, u8 pieceId>
     Bitboard internalCalculateThreat(Bitboard bounds) const;
@@ -266,6 +339,8 @@ private:
     u64 Castling(byte set, byte castling, u64 threatenedMask) const;
 
     mutable MaterialPositionMask m_materialMask;
+    // piece on each square, mirrors the bitboards so lookups don't have to scan them.
+    ChessPiece m_mailbox[64];
     CastlingStateInfo m_castlingState;
     EnPassantStateInfo m_enpassantState;
 };
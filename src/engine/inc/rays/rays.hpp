@@ -6,8 +6,6 @@
 
 namespace ray {
 namespace internals {
-void initialize();
-
 constexpr std::array<std::array<u64, 64>, 64> computeRays() {
     std::array<std::array<u64, 64>, 64> raysTable{};
 
@@ -27,13 +25,14 @@ constexpr std::array<std::array<u64, 64>, 64> computeRays() {
             u64 rookAttacks = attacks::internals::generateRookAttackMask<true>(from, 0);
             u64 bishopAttacks = attacks::internals::generateBishopAttackMask<true>(from, 0);
 
+            // the generators agree with the attack table lookups, but can be evaluated at compile time.
             if ((rookAttacks & toMask) > 0) {
-                result = attacks::getRookAttacks(from, fromMask | toMask);
-                result &= attacks::getRookAttacks(to, fromMask | toMask) | toMask; // adding destination square to the mask
+                result = attacks::internals::generateRookAttackMask<true>(from, fromMask | toMask);
+                result &= attacks::internals::generateRookAttackMask<true>(to, fromMask | toMask) | toMask; // adding destination square to the mask
             }
             else if ((bishopAttacks & toMask) > 0) {
-                result = attacks::getBishopAttacks(from, fromMask | toMask);
-                result &= attacks::getBishopAttacks(to, fromMask | toMask) | toMask; // adding destination square to the mask
+                result = attacks::internals::generateBishopAttackMask<true>(from, fromMask | toMask);
+                result &= attacks::internals::generateBishopAttackMask<true>(to, fromMask | toMask) | toMask; // adding destination square to the mask
             }
 
             raysTable[from][to] = result;
@@ -43,8 +42,13 @@ constexpr std::array<std::array<u64, 64>, 64> computeRays() {
     return raysTable;
 }
 
+// baked at compile time in rays.cpp.
+extern const std::array<std::array<u64, 64>, 64> raysTable;
+
 } // namespace internals
 
-u64 getRay(u8 from, u8 to);
+inline u64 getRay(u8 from, u8 to) {
+    return internals::raysTable[from][to];
+}
 
 } // namespace ray
\ No newline at end of file
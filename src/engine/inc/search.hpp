@@ -14,6 +14,7 @@
 // You should have received a copy of the GNU General Public License
 // along with this program.If not, see < http://www.gnu.org/licenses/>.
 
+#include <atomic>
 #include <functional>
 #include <map>
 #include <optional>
@@ -22,6 +23,7 @@
 #include "defines.hpp"
 #include "evaluation_table.hpp"
 #include "move.h"
+#include "time_manager.hpp"
 #include "transposition_table.hpp"
 
 class Chessboard;
@@ -64,6 +66,20 @@ struct SearchParameters {
 
     u32 MovesToGo = 0;
 
+    // maximum amount of nodes to search, deterministic alternative to time limits.
+    // 0 = no node limit.
+    u64 NodeLimit = 0;
+
+    // search for a forced mate in at most this many moves with the dedicated mate solver.
+    // 0 = regular search.
+    u32 MateIn = 0;
+
+    // amount of best lines to search and report.
+    u32 MultiPV = 1;
+
+    // restricts the root to these moves, empty = all legal moves.
+    std::vector<PackedMove> SearchMoves = {};
+
     bool Infinite = false;
 };
 
@@ -74,14 +90,21 @@ struct SearchResult {
     u64 count = 0;
 };
 
-typedef std::function<bool()> CancelSearchCondition;
+struct RootMove {
+    PackedMove move;
+    i32 score = 0;
+    // nodes spent searching this move in the last iteration.
+    u64 nodes = 0;
+};
 
 struct SearchContext {
     GameContext& game;
     u64& nodes;
-    CancelSearchCondition& cancel;
 };
 
+// amount of stop checks between polling the clock, keep it a power of two.
+static constexpr u32 c_stopPollInterval = 2048;
+
 struct PerftResult {
     u64 Nodes = 0;
     u64 Captures = 0;
@@ -113,23 +136,66 @@ public:
     u64 Bench(GameContext& context, u32 depth);
 
     SearchResult CalculateBestMove(GameContext& context, SearchParameters params);
-    i32 CalculateMove(GameContext& context, bool maximizingPlayer, u32 depth);
+    i32 CalculateMove(GameContext& context, u32 depth);
+
+    /**
+     * @brief Requests a running search to stop as soon as possible, safe to call from another thread.  */
+    void stop() { m_stop.store(true, std::memory_order_relaxed); }
+
+    /**
+     * @brief Nodes of every iteration of the last CalculateBestMove, cancelled ones included.  */
+    u64 readNodesSearched() const { return m_nodesSearched; }
 
     void clear();
+    /**
+     * @brief Ages the move ordering state between moves of a game, history is halved so it keeps
+     * its ordering but recent searches weigh more, killers are ply relative and cleared.  */
+    void decayHistory();
     bool isKillerMove(PackedMove move, u32 ply) const;
     u32 getHistoryHeuristic(u8 set, u8 src, u8 dst) const;
 
 private:
-    void ReportSearchResult(SearchContext& context, SearchResult& searchResult, u32 searchDepth, u32 itrDepth, u64 nodes, const Clock& clock) const;
-
-
-    SearchResult    CalculateBestMoveIterration(SearchContext& context, u32 depth);
-    SearchResult    AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alpha, i32 beta, bool maximizingPlayer, u32 ply);
-    i32             QuiescenceNegamax(SearchContext& context, u32 depth, i32 alpha, i32 beta, bool maximizingPlayer, u32 ply);
-
-    bool TimeManagement(i64 elapsedTime, i64 timeleft, i32 timeInc, u32 depth);
-    CancelSearchCondition buildCancellationFunction(Set perspective, const SearchParameters& params, const Clock& clock) const;
-
+    void ReportSearchResult(SearchContext& context, SearchResult& searchResult, u32 searchDepth, u32 itrDepth, u64 nodes, const Clock& clock, u32 multiPV) const;
+
+    /**
+     * @brief Collects the legal root moves in move generator order, limited to searchMoves if any.  */
+    void BuildRootMoves(GameContext& context, const std::vector<PackedMove>& searchMoves);
+
+    SearchResult    CalculateBestMoveIterration(SearchContext& context, u32 depth, u32 pvIndex);
+
+    /**
+     * @brief Searches the root moves from pvIndex and onwards, moves before pvIndex are the better
+     * lines found earlier in the iteration. Afterwards m_rootMoves[pvIndex] holds the best move
+     * of the line.  */
+    template<Set us>
+    SearchResult    SearchRoot(SearchContext& context, u32 depth, u32 pvIndex);
+
+    /**
+     * @brief Search is templated on the side to move so all perspective dependent code is
+     * resolved at compile time, each ply flips the template argument.  */
+    template<Set us>
+    SearchResult    AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alpha, i32 beta, u32 ply);
+    /**
+     * @brief Resolves captures until the position is quiet, qply counts plies beyond the main
+     * search horizon and ply is the distance from root.  */
+    template<Set us>
+    i32             QuiescenceNegamax(SearchContext& context, u32 qply, i32 alpha, i32 beta, u32 ply);
+
+
+    /**
+     * @brief Checked at every node. The node limit is a plain comparison and checked every time so
+     * go nodes stops on the limit, only the clock is polled every c_stopPollInterval calls.  */
+    inline bool isStopped(const SearchContext& context)
+    {
+        if (m_nodeLimit > 0 && m_nodesSearched + context.nodes >= m_nodeLimit)
+            stop();
+        if (--m_pollCountdown == 0) {
+            m_pollCountdown = c_stopPollInterval;
+            if (m_timeManager != nullptr && m_timeManager->hardLimitReached())
+                stop();
+        }
+        return m_stop.load(std::memory_order_relaxed);
+    }
 
     i32 Extension(const Chessboard& board, const PrioratizedMove& prioratized, u32 ply) const;
     void pushKillerMove(PackedMove mv, u32 ply);
@@ -141,4 +207,13 @@ private:
     PackedMove m_killerMoves[4][64];
     u32 m_historyHeuristic[2][64][64];
 
+    std::vector<RootMove> m_rootMoves;
+
+    std::atomic<bool> m_stop = false;
+    u32 m_pollCountdown = c_stopPollInterval;
+    const TimeManager* m_timeManager = nullptr;
+    u64 m_nodeLimit = 0;
+    // nodes searched in previous iterations, context only counts the current one.
+    u64 m_nodesSearched = 0;
+
 };
\ No newline at end of file
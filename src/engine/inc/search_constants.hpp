@@ -22,4 +22,8 @@ static constexpr i32 c_checkmateConstant = 24000;
 static constexpr i32 c_checkmateMaxDistance = 256;
 static constexpr i32 c_checkmateMinScore = c_checkmateConstant - c_checkmateMaxDistance;
 static constexpr i32 c_drawConstant = 0;
+// quiescence search plies beyond the horizon before we trust the static evaluation.
+static constexpr u32 c_maxQuiescenceDepth = 32;
+// captures which can't raise the score above alpha even with this margin are pruned.
+static constexpr i32 c_deltaPruningMargin = 200;
 //static constexpr i32 c_pvScore = 10000;
\ No newline at end of file
@@ -1,13 +0,0 @@
-#pragma once
-
-#include "attacks/attacks.hpp"
-#include "rays/rays.hpp"
-
-namespace static_initializer {
-bool initialize() {
-    attacks::internals::initialize();
-    ray::internals::initialize();
-    return true;
-}
-
-} // namespace static_initializer
\ No newline at end of file
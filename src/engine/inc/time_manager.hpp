@@ -0,0 +1,73 @@
+// Elephant Gambit Chess Engine - a Chess AI
+// Copyright(C) 2021-2024  Alexander Loodin Ek
+
+// This program is free software : you can redistribute it and /or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+// along with this program.If not, see < http://www.gnu.org/licenses/>.
+#pragma once
+#include "clock.hpp"
+#include "defines.hpp"
+#include "move.h"
+
+struct SearchParameters;
+
+namespace time_manager_constants {
+// time reserved for communication with the gui, in milliseconds.
+constexpr i64 moveOverhead = 30;
+// moves we expect to play in a sudden death time control when no movestogo is given.
+constexpr i64 defaultMovesToGo = 30;
+constexpr i64 maxMovesToGo = 50;
+// the hard limit is never further away than this multiple of the soft limit.
+constexpr i64 hardLimitFactor = 5;
+}  // namespace time_manager_constants
+
+/**
+ * @brief Keeps track of how long we're allowed to search for a move. The hard limit is polled during
+ * search and aborts it, the soft limit is checked between iterations and scales with how settled the
+ * search looks. An unstable best move, a dropping score or nodes spread over many root moves all grant
+ * more time, a stable best move soaking up most nodes gives up time early.  */
+class TimeManager {
+public:
+    TimeManager() = default;
+
+    /**
+     * @brief Starts the clock and calculates soft and hard deadlines for the side to move.  */
+    void begin(const SearchParameters& params, Set perspective);
+
+    /**
+     * @brief Updates the soft limit scaling after a completed iteration.
+     * @param bestMove best move of the iteration.
+     * @param score score of the iteration.
+     * @param bestMoveNodes nodes spent searching the best move.
+     * @param totalNodes nodes spent in the iteration.  */
+    void update(PackedMove bestMove, i32 score, u64 bestMoveNodes, u64 totalNodes);
+
+    bool hasTimeLimit() const { return m_hardLimit > 0; }
+    bool hardLimitReached() const { return hasTimeLimit() && m_clock.getElapsedTime() >= m_hardLimit; }
+    bool softLimitReached() const { return hasTimeLimit() && m_clock.getElapsedTime() >= readSoftLimit(); }
+
+    i64 readSoftLimit() const;
+    i64 readHardLimit() const { return m_hardLimit; }
+    i64 readElapsedTime() const { return m_clock.getElapsedTime(); }
+
+private:
+    Clock m_clock;
+    i64 m_softLimit = 0;
+    i64 m_hardLimit = 0;
+
+    PackedMove m_bestMove = PackedMove::NullMove();
+    u32 m_stability = 0;
+    i32 m_previousScore = 0;
+    bool m_hasPreviousScore = false;
+    float m_scale = 1.f;
+    bool m_fixedTime = false;
+};
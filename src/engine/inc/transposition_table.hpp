@@ -2,11 +2,14 @@
 #include "defines.hpp"
 #include "log.h"
 #include "move.h"
+#include "numa.hpp"
 #include "search_constants.hpp"
 
 #include <algorithm>
+#include <memory>
+#include <new>
 #include <optional>
-#include <vector>
+#include <type_traits>
 
 struct Move;
 
@@ -111,16 +114,26 @@ static_assert(sizeof(TranspositionEntry) == 16, "TranspositionEntry size is not
 
 template<typename T>
 class TranspositionTableImpl {
+    // entries are zeroed with memset by threads bound to each memory node.
+    static_assert(std::is_trivially_copyable_v<T>, "transposition entries have to be trivially copyable");
+
 public:
     TranspositionTableImpl();
     void resize(u32 megabytes);
+    /**
+     * @brief Zeroes all entries, keeping the allocation and its page placement.  */
     void clear();
 
+    /**
+     * @brief Sets how many bound threads initialize the table and how its pages are spread over
+     * the memory nodes, takes effect on the next resize.  */
+    void setPlacement(u32 threads, numa::Placement placement);
+
     //inline u64 entryIndex(u64 hash) const { return ((i128)hash * (i128)m_elementCountMax) >> 64; }
     inline u64 entryIndex(u64 hash) const { return hash & m_mask; }
 
-    inline u64 readSize() const { return m_table.size(); }
-    inline u64 readSizeMegaBytes() const { return m_table.size() * sizeof(T) / (1024 * 1024); }
+    inline u64 readSize() const { return m_elementCountMax; }
+    inline u64 readSizeMegaBytes() const { return m_elementCountMax * sizeof(T) / (1024 * 1024); }
 
     const T& readEntry(u64 hash) const { return m_table[entryIndex(hash)]; }
     T& editEntry(u64 hash) { return m_table[entryIndex(hash)]; }
@@ -134,9 +147,17 @@ public:
 #endif
 
 private:
-    std::vector<T> m_table;
+    struct AlignedDelete {
+        void operator()(T* table) const { ::operator delete[](table, std::align_val_t{ 64 }); }
+    };
+
+    // raw allocation rather than a vector, value initializing would touch every page from the
+    // allocating thread and place the whole table on its node.
+    std::unique_ptr<T[], AlignedDelete> m_table;
     u64 m_elementCountMax;
     u64 m_mask;
+    u32 m_threads = 1;
+    numa::Placement m_placement = numa::Placement::FirstTouch;
 };
 
 
@@ -165,17 +186,25 @@ void TranspositionTableImpl<T>::resize(u32 megabytes)
     LOG_WARNING_EXPR(megabytes < c_tableMaxSize) << "TranspositionTableImpl::resize() requested size is too large, resizing to "
         << c_tableMaxSize << "mb instead of " << megabytes << "mb.";
 
-    this->clear();
-    m_table.resize(newSize);
-    m_table.shrink_to_fit();
+    // always a fresh allocation, pages which are already touched wouldn't move to another node.
+    m_table.reset();
+    m_table.reset(static_cast<T*>(::operator new[](newSize * sizeof(T), std::align_val_t{ 64 })));
     m_elementCountMax = newSize;
     m_mask = newSize - 1;
+    this->clear();
+}
+
+template<class T>
+void TranspositionTableImpl<T>::setPlacement(u32 threads, numa::Placement placement)
+{
+    m_threads = std::max(1u, threads);
+    m_placement = placement;
 }
 
 template<class T>
 void TranspositionTableImpl<T>::clear()
 {
-    m_table.clear();
+    numa::parallelFill(m_table.get(), m_elementCountMax * sizeof(T), m_threads, m_placement);
 #ifdef DEBUG_TRANSITION_TABLE
     s_writes = 0;
     s_reads = 0;
@@ -60,6 +60,10 @@ private:
     /**
      * initialize the engines options with default values    */
     void InitializeOptions();
+    /**
+     * Reallocates the transposition table with the placement given by the Threads and
+     * NumaPlacement options.    */
+    void ApplyTranspositionTablePlacement();
 
     bool m_enabled;
     GameContext m_context;
@@ -14,6 +14,7 @@ ${ENGINE_INC_DIR}/elephant_gambit.h
 ${ENGINE_INC_DIR}/elephant_gambit_config.h
 ${ENGINE_INC_DIR}/defines.hpp
 ${ENGINE_INC_DIR}/libpopcnt.h
+${ENGINE_INC_DIR}/attack_maps.hpp
 ${ENGINE_INC_DIR}/attacks/attacks.hpp
 ${ENGINE_INC_DIR}/attacks/magic_constants.hpp
 ${ENGINE_INC_DIR}/bitboard.hpp
@@ -21,6 +22,7 @@ ${ENGINE_INC_DIR}/bitboard_constants.hpp
 ${ENGINE_INC_DIR}/chessboard.h
 ${ENGINE_INC_DIR}/chess_piece.h
 ${ENGINE_INC_DIR}/clock.hpp
+${ENGINE_INC_DIR}/cpu.hpp
 ${ENGINE_INC_DIR}/evaluation_table.hpp
 ${ENGINE_INC_DIR}/evaluator.h
 ${ENGINE_INC_DIR}/fen_parser.h
@@ -31,13 +33,16 @@ ${ENGINE_INC_DIR}/king_pin_threats.hpp
 ${ENGINE_INC_DIR}/log.h
 ${ENGINE_INC_DIR}/move.h
 ${ENGINE_INC_DIR}/notation.h
+${ENGINE_INC_DIR}/numa.hpp
 ${ENGINE_INC_DIR}/material_mask.hpp
+${ENGINE_INC_DIR}/mate_search.hpp
 ${ENGINE_INC_DIR}/move_generator.hpp
+${ENGINE_INC_DIR}/move_list.hpp
 ${ENGINE_INC_DIR}/position.hpp
 ${ENGINE_INC_DIR}/rays/rays.hpp
 ${ENGINE_INC_DIR}/search.hpp
 ${ENGINE_INC_DIR}/search_constants.hpp
-${ENGINE_INC_DIR}/static_initializer.hpp
+${ENGINE_INC_DIR}/time_manager.hpp
 ${ENGINE_INC_DIR}/transposition_table.hpp
 ${ENGINE_INC_DIR}/uci.hpp
 )
@@ -45,11 +50,13 @@ ${ENGINE_INC_DIR}/uci.hpp
 set(ENGINE_SOURCE ${ENGINE_SOURCE}
 ${ENGINE_SRC_DIR}/elephant_gambit.cpp
 
+${ENGINE_SRC_DIR}/attack_maps.cpp
 ${ENGINE_SRC_DIR}/attacks.cpp
 ${ENGINE_SRC_DIR}/bitboard.cpp
 ${ENGINE_SRC_DIR}/chessboard.cpp
 ${ENGINE_SRC_DIR}/chess_piece.cpp
 ${ENGINE_SRC_DIR}/clock.cpp
+${ENGINE_SRC_DIR}/cpu.cpp
 ${ENGINE_SRC_DIR}/evaluator.cpp
 ${ENGINE_SRC_DIR}/evaluator_data.h
 ${ENGINE_SRC_DIR}/fen_parser.cpp
@@ -57,13 +64,17 @@ ${ENGINE_SRC_DIR}/game_context.cpp
 ${ENGINE_SRC_DIR}/hash_zorbist.cpp
 ${ENGINE_SRC_DIR}/king_pin_threats.cpp
 ${ENGINE_SRC_DIR}/log.cpp
+${ENGINE_SRC_DIR}/mate_search.cpp
 ${ENGINE_SRC_DIR}/material_mask.cpp
 ${ENGINE_SRC_DIR}/move.cpp
 ${ENGINE_SRC_DIR}/notation.cpp
+${ENGINE_SRC_DIR}/numa.cpp
 ${ENGINE_SRC_DIR}/move_generator.cpp
+${ENGINE_SRC_DIR}/move_list.cpp
 ${ENGINE_SRC_DIR}/position.cpp
 ${ENGINE_SRC_DIR}/rays.cpp 
 ${ENGINE_SRC_DIR}/search.cpp
+${ENGINE_SRC_DIR}/time_manager.cpp
 ${ENGINE_SRC_DIR}/uci.cpp
 )
 
@@ -0,0 +1,92 @@
+#include "attack_maps.hpp"
+#include "attacks/attacks.hpp"
+#include "position.hpp"
+
+AttackMaps::AttackMaps(const Position& position) :
+    m_position(position),
+    m_computed{ false, false }
+{
+}
+
+Bitboard AttackMaps::bySet(Set set) const
+{
+    ensure(set);
+    return m_bySet[static_cast<u8>(set)];
+}
+
+Bitboard AttackMaps::byPiece(Set set, u8 pieceId) const
+{
+    ensure(set);
+    return m_byPiece[static_cast<u8>(set)][pieceId];
+}
+
+Bitboard AttackMaps::bySquare(Square sqr) const
+{
+    const ChessPiece piece = m_position.readPieceAt(sqr);
+    if (piece.isValid() == false)
+        return Bitboard();
+
+    ensure(piece.getSet());
+    return m_bySquare[static_cast<u8>(sqr)];
+}
+
+void AttackMaps::ensure(Set set) const
+{
+    if (m_computed[static_cast<u8>(set)])
+        return;
+
+    if (set == Set::WHITE)
+        compute<Set::WHITE>();
+    else
+        compute<Set::BLACK>();
+}
+
+template<Set set>
+void AttackMaps::compute() const
+{
+    constexpr u8 setId = static_cast<u8>(set);
+    constexpr Set op = opposing_set<set>();
+    const auto& material = m_position.readMaterial();
+    const u64 occupancy = (material.combine() & ~material.kings<op>()).read();
+
+    m_bySet[setId] = Bitboard();
+    for (u8 pieceId = pawnId; pieceId <= kingId; ++pieceId) {
+        Bitboard pieces = material.read<set>(pieceId);
+        Bitboard pieceAttacks;
+        while (pieces.empty() == false) {
+            const u8 sqr = static_cast<u8>(pieces.popLsb());
+            u64 attacked = 0;
+            switch (pieceId) {
+                case pawnId:
+                    attacked = attacks::getPawnAttacks(setId, sqr);
+                    break;
+                case knightId:
+                    attacked = attacks::getKnightAttacks(sqr);
+                    break;
+                case bishopId:
+                    attacked = attacks::getBishopAttacks(sqr, occupancy);
+                    break;
+                case rookId:
+                    attacked = attacks::getRookAttacks(sqr, occupancy);
+                    break;
+                case queenId:
+                    attacked = attacks::getBishopAttacks(sqr, occupancy) | attacks::getRookAttacks(sqr, occupancy);
+                    break;
+                default:
+                    attacked = attacks::getKingAttacks(sqr);
+                    break;
+            }
+
+            m_bySquare[sqr] = attacked;
+            pieceAttacks |= attacked;
+        }
+
+        m_byPiece[setId][pieceId] = pieceAttacks;
+        m_bySet[setId] |= pieceAttacks;
+    }
+
+    m_computed[setId] = true;
+}
+
+template void AttackMaps::compute<Set::WHITE>() const;
+template void AttackMaps::compute<Set::BLACK>() const;
@@ -19,26 +19,6 @@ Chessboard::Chessboard() :
     m_age(0),
     m_endGameCoeficient(0.f)
 {
-    m_kings[0].first = ChessPiece::None();
-    m_kings[0].second = Notation();
-    m_kings[1].first = ChessPiece::None();
-    m_kings[1].second = Notation();
-}
-
-Chessboard::Chessboard(const Chessboard& other) :
-    m_hash(other.readHash()),
-    m_isWhiteTurn(other.m_isWhiteTurn),
-    m_moveCount(other.m_moveCount),
-    m_plyCount(other.m_plyCount),
-    m_age(other.m_age),
-    m_endGameCoeficient(other.m_endGameCoeficient)
-{
-    m_kings[0].first = other.m_kings[0].first;
-    m_kings[0].second = Notation(other.m_kings[0].second);
-    m_kings[1].first = other.m_kings[1].first;
-    m_kings[1].second = Notation(other.m_kings[1].second);
-
-    m_position = other.m_position;
 }
 
 std::string
@@ -79,10 +59,6 @@ void
 Chessboard::Clear()
 {
     m_hash = 0;
-    m_kings[0].first = ChessPiece::None();
-    m_kings[0].second = Notation();
-    m_kings[1].first = ChessPiece::None();
-    m_kings[1].second = Notation();
     m_position.Clear();
     m_plyCount = 0;
     m_isWhiteTurn = true;
@@ -103,11 +79,6 @@ Chessboard::PlacePiece(ChessPiece piece, Notation target, bool overwrite)
             return false;  // already a piece on this square
     }
 
-    if (piece.getType() == PieceType::KING) {
-        m_kings[piece.set()].first = piece;
-        m_kings[piece.set()].second = Notation(target);
-    }
-
     m_position.PlacePiece(piece, trgSqr);
 
     m_hash = ZorbistHash::Instance().HashPiecePlacement(m_hash, piece, target);
@@ -119,6 +90,16 @@ MoveUndoUnit
 Chessboard::MakeMove(const PackedMove move)
 {
     MoveUndoUnit undoState;
+    MakeMove<validation>(move, undoState);
+    return undoState;
+}
+
+template<bool validation>
+void
+Chessboard::MakeMove(const PackedMove move, MoveUndoUnit& undoState)
+{
+    // frames of the state stack are reused, wipe whatever the previous move left behind.
+    undoState = MoveUndoUnit();
     undoState.move = move;
     undoState.hash = m_hash;
     undoState.plyCount = m_plyCount;
@@ -127,7 +108,6 @@ Chessboard::MakeMove(const PackedMove move)
     auto piece = m_position.readPieceAt(move.sourceSqr());
     undoState.movedPiece = piece;
 
-    auto materialEditor = m_position.materialEditor(piece.getSet(), piece.getType());
     const Square targetSqr = move.targetSqr();
 
     // cache captureTarget in seperate variable since we might be capturing enpassant
@@ -137,11 +117,15 @@ Chessboard::MakeMove(const PackedMove move)
     undoState.enPassantState.write(m_position.readEnPassant().read());
     undoState.castlingState.write(m_position.readCastling().read());
 
+    // incremented before handling the move since pawn moves and captures reset it.
+    m_plyCount++;
+    m_age++;
+
     switch (piece.getType()) {
     case PieceType::PAWN:
         // updating pieceTarget since if we're capturing enpassant the target will be on a
         // different square.
-        std::tie(captureTarget, piece) = InternalHandlePawnMove(move, piece.getSet(), materialEditor, undoState);
+        std::tie(captureTarget, piece) = InternalHandlePawnMove(move, piece.getSet(), undoState);
         m_plyCount = 0;  // reset ply count on pawn move
         break;
 
@@ -160,15 +144,11 @@ Chessboard::MakeMove(const PackedMove move)
         m_position.editEnPassant().clear();
     }
 
-    // since capture will reset this to 0, we need to increment it here.
-    m_plyCount++;
-    m_age++;
-
     if (move.isCapture())
         InternalHandleCapture(move, captureTarget, undoState);
 
     // should happen after capture since enpassant logic relies on that order.
-    InternalMakeMove(piece, move.sourceSqr(), move.targetSqr(), materialEditor);
+    InternalMakeMove(piece, move.sourceSqr(), move.targetSqr());
 
     // unless something goes wrong, updating the black to move hash should remove it when it's time for white to move,
     // or add it when it's time for black to move.
@@ -177,12 +157,32 @@ Chessboard::MakeMove(const PackedMove move)
     // flip the bool and if we're back at white turn we assume we just made a black turn and hence we increment the move count.
     m_isWhiteTurn = !m_isWhiteTurn;
     m_moveCount += (short)m_isWhiteTurn;
-
-    return undoState;
 }
 
 template MoveUndoUnit Chessboard::MakeMove<true>(PackedMove);
 template MoveUndoUnit Chessboard::MakeMove<false>(PackedMove);
+template void Chessboard::MakeMove<true>(PackedMove, MoveUndoUnit&);
+template void Chessboard::MakeMove<false>(PackedMove, MoveUndoUnit&);
+
+void
+Chessboard::SaveSnapshot(BoardSnapshot& snapshot) const
+{
+    snapshot.position = m_position;
+    snapshot.hash = m_hash;
+    snapshot.plyCount = m_plyCount;
+}
+
+void
+Chessboard::RestoreSnapshot(const BoardSnapshot& snapshot)
+{
+    m_position = snapshot.position;
+    m_hash = snapshot.hash;
+    m_plyCount = snapshot.plyCount;
+    // the rest only ever steps by one per move.
+    m_moveCount -= (short)m_isWhiteTurn;
+    m_isWhiteTurn = !m_isWhiteTurn;
+    m_age--;
+}
 
 bool
 Chessboard::UnmakeMove(const MoveUndoUnit& undoState)
@@ -192,16 +192,15 @@ Chessboard::UnmakeMove(const MoveUndoUnit& undoState)
     //const ChessPiece movedPiece = m_position.readPieceAt((Square)trgSqr);
     const ChessPiece movedPiece = undoState.movedPiece;
 
-    // idea here is to store the piece to place back on the board in this variable,
-    // if we're dealing with a promotion this will be a pawn of the correct set.
-    // otherwise it will be the same piece as movedPiece.
-    const ChessPiece promotedPiece =
-        undoState.move.isPromotion() ? ChessPiece(movedPiece.getSet(), PieceType::PAWN) : movedPiece;
-
-    // unmake move, currently we are tracking the piece and board state in two
-    // different places, here in our tiles and in the position.
-    m_position.PlacePiece(promotedPiece, srcSqr);
-    m_position.ClearPiece(movedPiece, trgSqr);
+    // a promotion puts a pawn back on the source square, any other piece is moved back with a
+    // single xor. captured pieces are restored after, once the target square is empty again.
+    if (undoState.move.isPromotion()) {
+        m_position.ClearPiece(movedPiece, trgSqr);
+        m_position.PlacePiece(ChessPiece(movedPiece.getSet(), PieceType::PAWN), srcSqr);
+    }
+    else {
+        m_position.MovePiece(movedPiece, trgSqr, srcSqr);
+    }
 
     if (undoState.move.isCapture()) {
         if (undoState.move.isEnPassant()) {
@@ -228,9 +227,8 @@ Chessboard::UnmakeMove(const MoveUndoUnit& undoState)
             rookSource = Notation(file_h, target.rank);
             rookTarget = Notation(file_f, target.rank);
         }
-        ChessPiece rook(movedPiece.getSet(), PieceType::ROOK);
-        auto editor = m_position.materialEditor(movedPiece.getSet(), PieceType::ROOK);
-        InternalMakeMove(rook, rookTarget.toSquare(), rookSource.toSquare(), editor);
+        // hash is restored from the undo state below, so there is no need to go through InternalMakeMove.
+        m_position.MovePiece(ChessPiece(movedPiece.getSet(), PieceType::ROOK), rookTarget.toSquare(), rookSource.toSquare());
     }
 
     m_position.editEnPassant().write(undoState.enPassantState.read());  // restore enpassant state
@@ -262,7 +260,7 @@ Chessboard::InternalUpdateEnPassant(Notation source, Notation target)
 }
 
 std::tuple<Square, ChessPiece>
-Chessboard::InternalHandlePawnMove(const PackedMove move, Set set, MutableMaterialProxy& materialEditor, MoveUndoUnit& undoState)
+Chessboard::InternalHandlePawnMove(const PackedMove move, Set set, MoveUndoUnit& undoState)
 {
     Square pieceTarget = move.targetSqr();
     const ChessPiece src(set, PieceType::PAWN);
@@ -294,10 +292,8 @@ Chessboard::InternalHandlePawnMove(const PackedMove move, Set set, MutableMateri
         // updating the piece on the source tile since we're doing this pre-move.
         // internal move will handle the actual move of the piece, but what piece it is doesn't
         // really mater at that point.
-        materialEditor[move.sourceSqr()] = false;
-        MutableMaterialProxy matPromoteEditor = m_position.materialEditor(set, static_cast<PieceType>(move.readPromoteToPieceType()));
-        matPromoteEditor[move.sourceSqr()] = true;
-        materialEditor = matPromoteEditor;
+        m_position.ClearPiece(src, move.sourceSqr());
+        m_position.PlacePiece(promote, move.sourceSqr());
         return std::make_tuple(pieceTarget, promote);
     }
 
@@ -345,8 +341,7 @@ Chessboard::InternalHandleKingMove(const PackedMove move, Set set, Square& targe
 void Chessboard::InternalHandleRookMove(const ChessPiece piece, const PackedMove move, Square targetRook, Square rookMove, MoveUndoUnit& undoState) {
     if (piece.getType() == PieceType::KING && targetRook != Square::NullSQ) {
         ChessPiece rook(piece.getSet(), PieceType::ROOK);
-        auto editor = m_position.materialEditor(piece.getSet(), PieceType::ROOK);
-        InternalMakeMove(rook, targetRook, rookMove, editor);
+        InternalMakeMove(rook, targetRook, rookMove);
     }
     else {
         InternalHandleRookMovedOrCaptured(move.sourceSqr(), undoState);
@@ -415,10 +410,9 @@ Chessboard::InternalHandleKingRookMove(const ChessPiece piece, const PackedMove
 }
 
 void
-Chessboard::InternalMakeMove(ChessPiece piece, Square source, Square target, MutableMaterialProxy materialEditor)
+Chessboard::InternalMakeMove(ChessPiece piece, Square source, Square target)
 {
-    materialEditor[source] = false;
-    materialEditor[target] = true;
+    m_position.MovePiece(piece, source, target);
 
     // update hash
     m_hash = ZorbistHash::Instance().HashPiecePlacement(m_hash, piece, target);
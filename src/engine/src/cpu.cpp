@@ -0,0 +1,103 @@
+#include "cpu.hpp"
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace cpu {
+
+Features detect()
+{
+    Features features;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    // the builtins also verify the os saves the avx registers.
+    __builtin_cpu_init();
+    features.popcnt = __builtin_cpu_supports("popcnt");
+    features.bmi2 = __builtin_cpu_supports("bmi2");
+    features.avx2 = __builtin_cpu_supports("avx2");
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    int regs[4];
+    __cpuid(regs, 0);
+    const int maxLeaf = regs[0];
+    __cpuid(regs, 1);
+    features.popcnt = (regs[2] & (1 << 23)) != 0;
+    const bool osSavesAvx = (regs[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    if (maxLeaf >= 7) {
+        __cpuidex(regs, 7, 0);
+        features.bmi2 = (regs[1] & (1 << 8)) != 0;
+        features.avx2 = osSavesAvx && (regs[1] & (1 << 5)) != 0;
+    }
+#endif
+    return features;
+}
+
+Level bestLevel(const Features& features)
+{
+    if (features.popcnt && features.bmi2 && features.avx2)
+        return Level::Avx2;
+    if (features.popcnt)
+        return Level::Popcnt;
+    return Level::Baseline;
+}
+
+Level activeLevel()
+{
+#if defined(CPU_DISPATCH_ACTIVE)
+    // same checks as the resolver of the clones.
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("x86-64-v3"))
+        return Level::Avx2;
+#if !defined(__BMI2__)
+    if (__builtin_cpu_supports("x86-64-v2"))
+        return Level::Popcnt;
+#endif
+#endif
+
+    // the default clone, or everything without dispatch, runs at the level the compiler targeted.
+#if defined(__AVX2__) && defined(__BMI2__)
+    return Level::Avx2;
+#elif defined(__POPCNT__)
+    return Level::Popcnt;
+#else
+    return Level::Baseline;
+#endif
+}
+
+const char* toString(Level level)
+{
+    switch (level) {
+        case Level::Avx2:
+            return "x86-64-v3";
+        case Level::Popcnt:
+            return "x86-64-v2";
+        default:
+            return "baseline";
+    }
+}
+
+std::string describe()
+{
+    const Features features = detect();
+    std::string result;
+    if (features.popcnt)
+        result += "popcnt ";
+    if (features.bmi2)
+        result += "bmi2 ";
+    if (features.avx2)
+        result += "avx2 ";
+    if (result.empty())
+        result = "none ";
+
+    result.pop_back();
+    result += ", path ";
+    result += toString(activeLevel());
+#if defined(CPU_DISPATCH_ACTIVE)
+    result += " (dispatch)";
+#else
+    result += " (static)";
+#endif
+    return result;
+}
+
+}  // namespace cpu
@@ -3,6 +3,7 @@
 #include "bitboard_constants.hpp"
 #include "chess_piece.h"
 #include "chessboard.h"
+#include "cpu.hpp"
 #include "evaluator_data.h"
 #include "fen_parser.h"
 #include "intrinsics.hpp"
@@ -11,7 +12,7 @@
 
 Evaluator::Evaluator() {}
 
-i32
+CPU_DISPATCH i32
 Evaluator::Evaluate(const Chessboard& board, const MoveGenerator& movegen)
 {
     i32 score = 0;
@@ -42,6 +43,17 @@ Evaluator::Evaluate(const Chessboard& board, const MoveGenerator& movegen)
     return score;
 }
 
+template<Set us>
+i32
+Evaluator::Evaluate(const Chessboard& board, const MoveGenerator& movegen)
+{
+    constexpr i32 perspective = us == Set::WHITE ? 1 : -1;
+    return Evaluate(board, movegen) * perspective;
+}
+
+template i32 Evaluator::Evaluate<Set::WHITE>(const Chessboard&, const MoveGenerator&);
+template i32 Evaluator::Evaluate<Set::BLACK>(const Chessboard&, const MoveGenerator&);
+
 i32 EvaluEvaluatePlus(const Chessboard&, const MoveGenerator&, PackedMove)
 {
     return 0;
@@ -195,14 +207,9 @@ i32 Evaluator::EvaluateKingSafety(const Chessboard& board, const MoveGenerator&
     Bitboard blackPawnWall = blackPawns & blackPawnWallMask;
     score -= blackPawnWall.count() * pawnWallFactor;
 
-    // evaluate pins and checks
-    const auto& whiteThreats = movegen.readKingPinThreats<Set::WHITE>();
-    Bitboard whitePins = whiteThreats.pins() & material.black();
-    score -= whitePins.count() * pinFactor;
-
-    const auto& blackThreats = movegen.readKingPinThreats<Set::BLACK>();
-    Bitboard blackPins = blackThreats.pins() & material.white();
-    score += blackPins.count() * pinFactor;
+    // evaluate pins, counted by the sliders pinning a piece to its king.
+    score -= movegen.readPinners<Set::WHITE>().count() * pinFactor;
+    score += movegen.readPinners<Set::BLACK>().count() * pinFactor;
 
     return score;
 }
@@ -158,6 +158,7 @@ FENParser::deserialize(const char* input, GameContext& outputContext)
     tokens.pop_front();
 
     outputContext.editChessboard().setPlyAndMoveCount(plyCount, moveCount);
+    outputContext.RefreshState();
 
     if (!tokens.empty())
         return false;
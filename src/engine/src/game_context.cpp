@@ -4,6 +4,7 @@
 #include "hash_zorbist.h"
 #include "move.h"
 #include "move_generator.hpp"
+#include "rays/rays.hpp"
 #include "search.hpp"
 
 #include <algorithm>
@@ -28,11 +29,41 @@ PrintCastlingState(const Chessboard& board)
     return ret;
 }
 
+GameContext::GameContext() :
+    m_ownTable(std::make_unique<TranspositionTable>()),
+    m_transpositionTable(m_ownTable.get()),
+    m_search(std::make_unique<Search>()),
+    m_states(c_stateStackSize)
+{
+    m_transpositionTable->resize(64);
+    Reset();
+}
+
+GameContext::GameContext(const GameContext& rhs) :
+    m_board(rhs.m_board),
+    m_ownTable(std::make_unique<TranspositionTable>()),
+    m_transpositionTable(m_ownTable.get()),
+    m_search(std::make_unique<Search>()),
+    m_states(c_stateStackSize)
+{
+    RefreshState();
+}
+
+GameContext::~GameContext() = default;
+
+void
+GameContext::shareTranspositionTable(TranspositionTable& table)
+{
+    m_transpositionTable = &table;
+    m_ownTable.reset();
+}
+
 void
 GameContext::Reset()
 {
     m_board.Clear();
-    m_undoUnits.clear();
+    m_stateIndex = 0;
+    m_states[0] = StateInfo();
     // keeping transposition table
 }
 
@@ -43,33 +74,62 @@ GameContext::NewGame()
     FENParser::deserialize(c_startPositionFen.c_str(), *this);
 }
 
+bool
+GameContext::IsFiftyMoveDraw() const
+{
+    if (IsFiftyMoveRule() == false)
+        return false;
+
+    // only checked positions can be mate, everything else is drawn right away.
+    MoveGenerator generator(*this);
+    if (generator.isChecked() == false)
+        return true;
+
+    return generator.generateNextMove().move.isNull() == false;
+}
+
 bool
 GameContext::GameOver() const
 {
-    // if (m_fiftyMoveRule >= 50) // not fully implemented yet
-    //     return true;
-    // if (readChessboard().isCheckmated(m_toPlay))
-    //     return true;
-    // if (readChessboard().isStalemated(m_toPlay))
-    //     return true;
+    if (IsFiftyMoveDraw() || m_board.readPosition().isInsufficientMaterial())
+        return true;
 
-    // Set opSet = ChessPiece::FlipSet(m_toPlay);
-    // if (readChessboard().isCheckmated(opSet))
-    //     return true;
-    // if (readChessboard().isStalemated(opSet))
-    //     return true;
+    if (IsRepetition(m_board.readHash()))
+        return true;
 
-    return false;
+    // no legal moves means either checkmate or stalemate.
+    MoveGenerator generator(*this);
+    return generator.generateNextMove().move.isNull();
 }
 
 bool
 GameContext::MakeMove(const PackedMove move)
 {
-    auto undoUnit = m_board.MakeMove<false>(move);
-    m_undoUnits.push_back(undoUnit);
+    FATAL_ASSERT(m_stateIndex + 1 < m_states.size()) << "State stack exhausted, missing ReserveStates";
+    StateInfo& state = m_states[++m_stateIndex];
+#if defined(ENABLE_COPY_MAKE)
+    m_board.SaveSnapshot(state.board);
+#endif
+    m_board.MakeMove<false>(move, state.undo);
+    std::tie(state.checkers, state.pinners, state.pinned) = m_board.readPosition().calcCheckersAndPins(m_board.readToPlay());
     return true;
 }
 
+void
+GameContext::ReserveStates(u32 plies)
+{
+    const size_t required = m_stateIndex + plies + 1;
+    if (required > m_states.size())
+        m_states.resize(std::max(required, m_states.size() * 2));
+}
+
+void
+GameContext::RefreshState()
+{
+    StateInfo& state = m_states[m_stateIndex];
+    std::tie(state.checkers, state.pinners, state.pinned) = m_board.readPosition().calcCheckersAndPins(m_board.readToPlay());
+}
+
 bool
 GameContext::TryMakeMove(Move move)
 {
@@ -78,12 +138,12 @@ GameContext::TryMakeMove(Move move)
         MoveGenerator generator(m_board.readPosition(), m_board.readToPlay(), move.Piece.getType());
         generator.generate();
 
-        generator.forEachMove([&](const PrioratizedMove& pm) {
+        for (const PrioratizedMove& pm : generator) {
             if (pm.move.targetSqr() == move.TargetSquare.toSquare()) {
                 found = pm.move;
-                return;
+                break;
             }
-            });
+        }
 
         if (found == PackedMove::NullMove())
             return false;
@@ -96,18 +156,23 @@ GameContext::TryMakeMove(Move move)
         found = move.readPackedMove();
     }
 
+    ReserveStates(1);
     return MakeMove(found);
 }
 
 bool
 GameContext::UnmakeMove()
 {
-    if (m_undoUnits.empty())
+    if (m_stateIndex == 0)
         return false;
 
-    auto undoUnit = m_undoUnits.back();
-    m_board.UnmakeMove(undoUnit);
-    m_undoUnits.pop_back();
+    // derived state of the previous ply is still in its frame, popping is all it takes.
+#if defined(ENABLE_COPY_MAKE)
+    m_board.RestoreSnapshot(m_states[m_stateIndex].board);
+#else
+    m_board.UnmakeMove(m_states[m_stateIndex].undo);
+#endif
+    m_stateIndex--;
 
     return true;
 }
@@ -115,28 +180,69 @@ GameContext::UnmakeMove()
 SearchResult
 GameContext::CalculateBestMove(SearchParameters params)
 {
-    Search search;
-    return search.CalculateBestMove(*this, params);
+    return m_search->CalculateBestMove(*this, params);
+}
+
+void
+GameContext::ClearSearch()
+{
+    m_search->clear();
 }
 
 bool
 GameContext::isGameOver() const
 {
-    return false;
+    return GameOver();
 }
 
 bool GameContext::IsRepetition(u64 hashKey) const {
-
-    if (m_undoUnits.size() < 4)
-        return false;
+    // positions before the last irreversible move can't repeat and only every other ply has the
+    // same side to move, the closest candidate is four plies back.
+    // the frame of the move made distance plies ago holds the hash from before that move.
+    const i32 end = std::min<i32>(m_board.readPlyCount(), static_cast<i32>(m_stateIndex));
+    const i32 size = static_cast<i32>(m_stateIndex) + 1;
 
     int count = 0;
-
-    auto itr = m_undoUnits.rbegin() + 1;
-    while (itr != m_undoUnits.rend()) {
-        if (itr->hash == hashKey)
+    for (i32 distance = 4; distance <= end; distance += 2) {
+        if (m_states[size - distance].undo.hash == hashKey)
             count++;
-        itr++;
     }
     return count >= 2;
-}
\ No newline at end of file
+}
+
+bool GameContext::HasUpcomingRepetition(u32 searchPly) const {
+    const i32 end = std::min<i32>(m_board.readPlyCount(), static_cast<i32>(m_stateIndex));
+    if (end < 3)
+        return false;
+
+    const i32 size = static_cast<i32>(m_stateIndex) + 1;
+    const u64 originalHash = m_board.readHash();
+    const auto& position = m_board.readPosition();
+    const Bitboard occupancy = position.readMaterial().combine();
+
+    // positions with the opponent to move, a single move by us away from the current one.
+    for (i32 distance = 3; distance <= end; distance += 2) {
+        u64 moveHash = originalHash ^ m_states[size - distance].undo.hash;
+        u8 src, trg;
+        if (ZorbistHash::Instance().CuckooLookup(moveHash, src, trg) == false)
+            continue;
+
+        // the squares between source and target have to be empty for the move to be possible.
+        if ((ray::getRay(src, trg) & ~squareMaskTable[trg] & occupancy.read()) != 0)
+            continue;
+
+        // both directions of a move share a slot, make sure it's our piece which would move.
+        ChessPiece piece = position.readPieceAt(static_cast<Square>(src));
+        if (piece.isValid() == false)
+            piece = position.readPieceAt(static_cast<Square>(trg));
+        if (piece.getSet() != readToPlay())
+            continue;
+
+        // the root is searchPly - 1 plies back. Like the reference cuckoo scheme only positions
+        // strictly after the root count, reaching the root again isn't a draw by itself.
+        if (searchPly > static_cast<u32>(distance) + 1)
+            return true;
+    }
+
+    return false;
+}
@@ -1,51 +1,142 @@
 #include "hash_zorbist.h"
+#include "attacks/attacks.hpp"
 #include "chessboard.h"
 
-// https://stackoverflow.com/questions/33010010/how-to-generate-random-64-bit-unsigned-integer-in-c
-#define IMAX_BITS(m) ((m) / ((m) % 255 + 1) / 255 % 255 * 8 + 7 - 86 / ((m) % 255 + 12))
-#define RAND_MAX_WIDTH IMAX_BITS(RAND_MAX)
-//_Static_assert((RAND_MAX& (RAND_MAX + 1u)) == 0, "RAND_MAX not a Mersenne number");
+#include <utility>
 
-u64
-rand64(void)
+namespace {
+/**
+ * @brief splitmix64, a constexpr replacement for rand() which gives the same keys on every
+ * platform and lets the whole table be built at compile time.  */
+constexpr u64
+random64(u64& state)
 {
-    u64 r = 0;
-    for (int i = 0; i < 64; i += RAND_MAX_WIDTH) {
-        r <<= RAND_MAX_WIDTH;
-        r ^= (unsigned)rand();
-    }
-    return r;
+    u64 z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
 }
 
-ZorbistHash ZorbistHash::instance;
-
-const ZorbistHash&
-ZorbistHash::Instance()
+// not constexpr, reaching it while the table is built at compile time fails the build.
+void
+unexpectedCuckooMoveCount()
 {
-    return instance;
 }
+}  // namespace
 
-void
+constexpr void
 ZorbistHash::GenerateZorbistTable()
 {
-    if (initialized)
-        LOG_ERROR() << "Zorbist Hash Table has already been initialized!";
-
-    black_to_move = rand64();
+    u64 state = 0x456c657068616e74ull;
+    black_to_move = random64(state);
 
     for (u8 i = 0; i < 8; ++i)
-        enpassant[i] = rand64();
+        enpassant[i] = random64(state);
 
     for (u8 i = 0; i < 4; ++i)
-        castling[i] = rand64();
+        castling[i] = random64(state);
 
     for (u8 i = 0; i < 64; ++i) {
         for (u8 p = 0; p < 12; ++p) {
-            table[i][p] = rand64();
+            table[i][p] = random64(state);
         }
     }
 
-    initialized = true;
+    GenerateCuckooTable();
+}
+
+constexpr void
+ZorbistHash::GenerateCuckooTable()
+{
+    // built from the constexpr empty board generators so the table can be baked at compile time.
+    auto emptyBoardAttacks = [](u8 pieceId, u8 sqr) -> u64 {
+        switch (pieceId) {
+        case knightId:
+            return attacks::internals::generateKnightAttackMask(sqr);
+        case bishopId:
+            return attacks::internals::generateBishopAttackMask<true>(sqr, 0);
+        case rookId:
+            return attacks::internals::generateRookAttackMask<true>(sqr, 0);
+        case queenId:
+            return attacks::internals::generateBishopAttackMask<true>(sqr, 0) | attacks::internals::generateRookAttackMask<true>(sqr, 0);
+        case kingId: {
+            u64 result = 0;
+            for (u8 trg = 0; trg < 64; ++trg) {
+                i32 fileDiff = (i32)(trg & 7) - (i32)(sqr & 7);
+                i32 rankDiff = (i32)(trg >> 3) - (i32)(sqr >> 3);
+                if (trg != sqr && fileDiff >= -1 && fileDiff <= 1 && rankDiff >= -1 && rankDiff <= 1)
+                    result |= squareMaskTable[trg];
+            }
+            return result;
+        }
+        default:
+            return 0;
+        }
+    };
+
+    for (u32 i = 0; i < 8192; ++i) {
+        cuckoo[i] = 0;
+        cuckooMoves[i] = 0;
+    }
+
+    u32 count = 0;
+    for (u8 set = 0; set < 2; ++set) {
+        for (u8 pieceId = knightId; pieceId <= kingId; ++pieceId) {
+            const u8 pieceIndx = pieceId + (set * 6);
+            for (u8 src = 0; src < 64; ++src) {
+                const u64 attacked = emptyBoardAttacks(pieceId, src);
+                for (u8 trg = src + 1; trg < 64; ++trg) {
+                    if ((attacked & squareMaskTable[trg]) == 0)
+                        continue;
+
+                    u64 key = table[src][pieceIndx] ^ table[trg][pieceIndx] ^ black_to_move;
+                    u16 move = src | (trg << 6);
+
+                    // insert, kicking out whatever occupies the slot until we find an empty one.
+                    u32 slot = CuckooH1(key);
+                    while (true) {
+                        std::swap(cuckoo[slot], key);
+                        std::swap(cuckooMoves[slot], move);
+                        if (move == 0)
+                            break;
+                        slot = (slot == CuckooH1(key)) ? CuckooH2(key) : CuckooH1(key);
+                    }
+                    count++;
+                }
+            }
+        }
+    }
+
+    if (count != 3668)
+        unexpectedCuckooMoveCount();
+}
+
+constexpr ZorbistHash::ZorbistHash()
+{
+    GenerateZorbistTable();
+}
+
+constexpr ZorbistHash ZorbistHash::instance;
+
+const ZorbistHash&
+ZorbistHash::Instance()
+{
+    return instance;
+}
+
+bool
+ZorbistHash::CuckooLookup(u64 hashDiff, u8& src, u8& trg) const
+{
+    u32 slot = CuckooH1(hashDiff);
+    if (cuckoo[slot] != hashDiff) {
+        slot = CuckooH2(hashDiff);
+        if (cuckoo[slot] != hashDiff)
+            return false;
+    }
+
+    src = cuckooMoves[slot] & 0x3f;
+    trg = (cuckooMoves[slot] >> 6) & 0x3f;
+    return true;
 }
 
 u64
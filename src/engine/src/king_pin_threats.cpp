@@ -1,5 +1,6 @@
 #include "king_pin_threats.hpp"
 #include "attacks/attacks.hpp"
+#include "cpu.hpp"
 #include "position.hpp"
 #include "rays/rays.hpp"
 
@@ -156,7 +157,7 @@ template void KingPinThreats::calculateEnPassantPinThreat<Set::WHITE>(Square, co
 template void KingPinThreats::calculateEnPassantPinThreat<Set::BLACK>(Square, const Position&);
 
 template<Set us>
-void KingPinThreats::evaluate(Square kingSquare, const Position& position)
+CPU_DISPATCH void KingPinThreats::evaluate(Square kingSquare, const Position& position)
 {
     constexpr Set op = opposing_set<us>();
     const Bitboard diagonalMaterial = position.readMaterial().bishops<op>() | position.readMaterial().queens<op>();
@@ -0,0 +1,192 @@
+#include "mate_search.hpp"
+#include "game_context.h"
+#include "move_generator.hpp"
+#include "search.hpp"
+
+#include <algorithm>
+
+namespace {
+u32 saturatingAdd(u32 lhs, u32 rhs)
+{
+    return std::min(lhs + rhs, mate_search_constants::infinity);
+}
+}  // namespace
+
+MateSearch::MateSearch(u32 tableSizeMb)
+{
+    u64 entries = ((u64)tableSizeMb * 1024 * 1024) / sizeof(Entry);
+    // round down to a power of two so we can index with a mask.
+    u64 size = 1;
+    while (size * 2 <= entries)
+        size *= 2;
+
+    m_table.resize(size);
+    m_mask = size - 1;
+}
+
+void MateSearch::clear()
+{
+    std::fill(m_table.begin(), m_table.end(), Entry());
+}
+
+const MateSearch::Entry& MateSearch::probe(u64 key) const
+{
+    static const Entry unexplored;
+    const Entry& entry = m_table[key & m_mask];
+    return entry.key == key ? entry : unexplored;
+}
+
+void MateSearch::store(u64 key, u32 proof, u32 disproof)
+{
+    Entry& entry = m_table[key & m_mask];
+    entry.key = key;
+    entry.proof = proof;
+    entry.disproof = disproof;
+}
+
+u32 MateSearch::generateChildren(GameContext& context, u32 remaining, bool attacker, Child* children, bool& inCheck)
+{
+    // the attacker has run out of moves to deliver mate with.
+    if (attacker && remaining == 0)
+        return 0;
+
+    MoveGenerator generator(context);
+    inCheck = generator.isChecked();
+
+    u32 count = 0;
+    PrioratizedMove prioratized = generator.generateNextMove();
+    while (prioratized.move.isNull() == false) {
+        context.MakeMove(prioratized.move);
+        // the attacker is only allowed moves which check the defending king.
+        if (attacker == false || context.readState().checkers.empty() == false) {
+            children[count].key = buildKey(context.readChessboard().readHash(), remaining - 1);
+            children[count].move = prioratized.move;
+            count++;
+        }
+        context.UnmakeMove();
+
+        // a defender without plies left isn't mated, we only need to know it has a move.
+        if (attacker == false && remaining == 0)
+            break;
+
+        prioratized = generator.generateNextMove();
+    }
+
+    return count;
+}
+
+void MateSearch::MID(GameContext& context, u32 remaining, u32 proofThreshold, u32 disproofThreshold, bool attacker)
+{
+    using namespace mate_search_constants;
+    ++m_nodes;
+
+    const u64 key = buildKey(context.readChessboard().readHash(), remaining);
+    Child children[maxMoves];
+    bool inCheck = false;
+    const u32 count = generateChildren(context, remaining, attacker, children, inCheck);
+
+    if (count == 0) {
+        // attacker without checks is disproven, defender without moves is mated or stalemated.
+        if (attacker || inCheck == false)
+            store(key, infinity, 0);
+        else
+            store(key, 0, infinity);
+        return;
+    }
+
+    if (attacker == false && remaining == 0) {
+        // defender has a legal move and survived.
+        store(key, infinity, 0);
+        return;
+    }
+
+    while (true) {
+        // the attacker (or node) needs a single proven child, the defender (and node) needs all of them.
+        u32 proof = attacker ? infinity : 0;
+        u32 disproof = attacker ? 0 : infinity;
+        u32 best = 0;
+        u32 bestNumber = infinity;
+        u32 secondNumber = infinity;
+        u32 bestOther = 0;
+
+        for (u32 i = 0; i < count; ++i) {
+            const Entry& entry = probe(children[i].key);
+            // the number we minimize over and the one we sum up, depending on node type.
+            const u32 minimized = attacker ? entry.proof : entry.disproof;
+            const u32 summed = attacker ? entry.disproof : entry.proof;
+
+            if (minimized < bestNumber) {
+                secondNumber = bestNumber;
+                bestNumber = minimized;
+                bestOther = summed;
+                best = i;
+            }
+            else if (minimized < secondNumber) {
+                secondNumber = minimized;
+            }
+
+            if (attacker)
+                disproof = saturatingAdd(disproof, summed);
+            else
+                proof = saturatingAdd(proof, summed);
+        }
+
+        if (attacker)
+            proof = bestNumber;
+        else
+            disproof = bestNumber;
+
+        if (proof >= proofThreshold || disproof >= disproofThreshold || isStopped()) {
+            store(key, proof, disproof);
+            if (remaining == m_rootRemaining && proof == 0)
+                m_rootMove = children[best].move;
+            return;
+        }
+
+        u32 childProofThreshold, childDisproofThreshold;
+        if (attacker) {
+            childProofThreshold = std::min(proofThreshold, secondNumber + 1);
+            childDisproofThreshold = disproofThreshold - disproof + bestOther;
+        }
+        else {
+            childProofThreshold = proofThreshold - proof + bestOther;
+            childDisproofThreshold = std::min(disproofThreshold, secondNumber + 1);
+        }
+
+        context.MakeMove(children[best].move);
+        MID(context, remaining - 1, childProofThreshold, childDisproofThreshold, !attacker);
+        context.UnmakeMove();
+    }
+}
+
+MateSearchResult MateSearch::Solve(GameContext& context, const SearchParameters& params)
+{
+    using namespace mate_search_constants;
+    MateSearchResult result;
+
+    m_stop.store(false, std::memory_order_relaxed);
+    m_pollCountdown = pollInterval;
+    m_nodeLimit = params.NodeLimit;
+    m_nodes = 0;
+    m_timeManager.begin(params, context.readToPlay());
+    context.RefreshState();
+    context.ReserveStates(params.MateIn * 2);
+
+    for (u32 mateIn = 1; mateIn <= params.MateIn; ++mateIn) {
+        m_rootRemaining = mateIn * 2 - 1;
+        m_rootMove = PackedMove::NullMove();
+
+        MID(context, m_rootRemaining, infinity, infinity, true);
+        if (m_rootMove.isNull() == false) {
+            result.move = m_rootMove;
+            result.mateIn = mateIn;
+            break;
+        }
+
+        if (m_stop.load(std::memory_order_relaxed))
+            break;
+    }
+
+    result.nodes = m_nodes;
+    return result;
+}
@@ -3,39 +3,21 @@
 bool MaterialPositionMask::empty() const
 {
     // assuming all of the m_materials are empty if sets are empty.
-    return m_set[0] == 0 && m_set[1] == 0;
-}
-
-const Bitboard MaterialPositionMask::combine() const
-{
-    return m_set[0] | m_set[1];
-}
-
-const Bitboard MaterialPositionMask::combine(Set set) const
-{
-    return m_set[static_cast<i8>(set)];
+    return m_occupancy == 0;
 }
 
 void MaterialPositionMask::write(Bitboard mask, Set set, i8 pieceId)
 {
     m_set[static_cast<i8>(set)] |= mask;
     m_material[pieceId] |= mask;
-}
-
-Bitboard MaterialPositionMask::read(i32 pieceId) const
-{
-    return m_material[pieceId];
-}
-
-Bitboard MaterialPositionMask::read(Set set, i8 pieceId) const
-{
-    return m_material[pieceId] & m_set[static_cast<i8>(set)];
+    m_occupancy |= mask;
 }
 
 void MaterialPositionMask::clear(Bitboard mask, Set set, i8 pieceId)
 {
     m_set[static_cast<i8>(set)] &= ~mask;
     m_material[pieceId] &= ~mask;
+    m_occupancy &= ~mask;
 }
 
 void MaterialPositionMask::clear()
@@ -45,4 +27,5 @@ void MaterialPositionMask::clear()
     for (i32 i = 0; i < 6; i++) {
         m_material[i] = 0;
     }
+    m_occupancy = 0;
 }
\ No newline at end of file
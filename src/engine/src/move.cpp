@@ -1,5 +1,6 @@
 #include "move.h"
 
+#include <algorithm>
 #include <list>
 #include <sstream>
 
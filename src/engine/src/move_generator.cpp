@@ -1,10 +1,13 @@
 #include "move_generator.hpp"
+#include "attacks/attacks.hpp"
 #include "game_context.h"
 #include "move.h"
+#include "rays/rays.hpp"
 #include "transposition_table.hpp"
 #include "search.hpp"
 
 #include <algorithm>
+#include <tuple>
 
 MoveGenerator::MoveGenerator(const Position& pos, Set toMove, PieceType ptype, MoveTypes mtype) :
     m_toMove(toMove),
@@ -13,10 +16,16 @@ MoveGenerator::MoveGenerator(const Position& pos, Set toMove, PieceType ptype, M
     m_search(nullptr),
     m_ply(0),
     m_hashKey(0),
+    m_pieceType(ptype),
+    m_moveTypes(mtype),
     m_movesGenerated(false),
-    m_moveCount(0),
-    m_currentMoveIndx(0),
-    m_movesBuffer()
+    m_arenaSlot(MoveArena::local().depth()),
+    m_moves(MoveArena::local().acquire()),
+    m_picker(),
+    m_kingMoves(),
+    m_kingSafetyComputed{ false, false },
+    m_checkInfo(),
+    m_attackMaps(m_position)
 {
     initializeMoveGenerator(ptype, mtype);
 }
@@ -28,10 +37,16 @@ MoveGenerator::MoveGenerator(const GameContext& context) :
     m_search(nullptr),
     m_ply(0),
     m_hashKey(0),
+    m_pieceType(PieceType::NONE),
+    m_moveTypes(MoveTypes::ALL),
     m_movesGenerated(false),
-    m_moveCount(0),
-    m_currentMoveIndx(0),
-    m_movesBuffer()
+    m_arenaSlot(MoveArena::local().depth()),
+    m_moves(MoveArena::local().acquire()),
+    m_picker(),
+    m_kingMoves(),
+    m_kingSafetyComputed{ false, false },
+    m_checkInfo(),
+    m_attackMaps(m_position)
 {
     initializeMoveGenerator(PieceType::NONE, MoveTypes::ALL);
 }
@@ -43,19 +58,64 @@ MoveGenerator::MoveGenerator(const GameContext& context, const TranspositionTabl
     m_search(&search),
     m_ply(ply),
     m_hashKey(context.readChessboard().readHash()),
+    m_pieceType(PieceType::NONE),
+    m_moveTypes(MoveTypes::ALL),
     m_movesGenerated(false),
-    m_moveCount(0),
-    m_currentMoveIndx(0),
-    m_movesBuffer()
+    m_arenaSlot(MoveArena::local().depth()),
+    m_moves(MoveArena::local().acquire()),
+    m_picker(),
+    m_kingMoves(),
+    m_kingSafetyComputed{ false, false },
+    m_checkInfo(),
+    m_attackMaps(m_position)
 {
+    initializeFromState(context);
     initializeMoveGenerator(PieceType::NONE, MoveTypes::ALL);
 }
 
+MoveGenerator::MoveGenerator(const GameContext& context, MoveTypes mtype) :
+    m_toMove(context.readToPlay()),
+    m_position(context.readChessboard().readPosition()),
+    m_tt(nullptr),
+    m_search(nullptr),
+    m_ply(0),
+    m_hashKey(0),
+    m_pieceType(PieceType::NONE),
+    m_moveTypes(mtype),
+    m_movesGenerated(false),
+    m_arenaSlot(MoveArena::local().depth()),
+    m_moves(MoveArena::local().acquire()),
+    m_picker(),
+    m_kingMoves(),
+    m_kingSafetyComputed{ false, false },
+    m_checkInfo(),
+    m_attackMaps(m_position)
+{
+    initializeFromState(context);
+    initializeMoveGenerator(PieceType::NONE, mtype);
+}
+
+MoveGenerator::~MoveGenerator()
+{
+    MoveArena::local().release(m_arenaSlot);
+}
+
+void
+MoveGenerator::initializeFromState(const GameContext& context)
+{
+    // the search makes every move through the context, so the state of the ply is up to date.
+    const StateInfo& state = context.readState();
+    const u8 toMoveIndx = static_cast<u8>(m_toMove);
+    m_checkers[toMoveIndx] = state.checkers;
+    m_pinners[toMoveIndx] = state.pinners;
+    m_pinned[toMoveIndx] = state.pinned;
+    m_kingSafetyComputed[toMoveIndx] = true;
+}
+
 PrioratizedMove
 MoveGenerator::generateNextMove() {
-    if (m_currentMoveIndx < m_moveCount) {
-        return m_movesBuffer[m_currentMoveIndx++];
-    }
+    if (m_picker.done(m_moves) == false)
+        return m_picker.next(m_moves);
 
     if (m_movesGenerated)
         return { PackedMove::NullMove(), 0 };
@@ -80,285 +140,413 @@ MoveGenerator::generate()
 
 template<Set set>
 PrioratizedMove MoveGenerator::generateNextMove() {
-    const size_t setIndx = static_cast<size_t>(set);
-    if (m_moveMasks[setIndx].combine().empty()) {
-        m_movesGenerated = true;
-        return { PackedMove::NullMove(), 0 };
-    }
-
-    if (m_movesGenerated == false) {
-        if (m_pinThreats->isCheckedCount() > 1) {
-            generateMoves<set, kingId>(m_pinThreats[setIndx]);
-        }
-        else {
-            generateMoves<set, pawnId>(m_pinThreats[setIndx]);
-            generateMoves<set, knightId>(m_pinThreats[setIndx]);
-            generateMoves<set, bishopId>(m_pinThreats[setIndx]);
-            generateMoves<set, rookId>(m_pinThreats[setIndx]);
-            generateMoves<set, queenId>(m_pinThreats[setIndx]);
-            generateMoves<set, kingId>(m_pinThreats[setIndx]);
-        }
-
-        sortMoves();
-
-    }
+    if (m_movesGenerated == false)
+        generateAllMoves<set>();
 
-    m_movesGenerated = true;
-    if (m_currentMoveIndx < m_moveCount) {
-        return m_movesBuffer[m_currentMoveIndx++];
-    }
+    if (m_picker.done(m_moves) == false)
+        return m_picker.next(m_moves);
 
     return { PackedMove::NullMove(), 0 };
 }
 
+template PrioratizedMove MoveGenerator::generateNextMove<Set::WHITE>();
+template PrioratizedMove MoveGenerator::generateNextMove<Set::BLACK>();
+
 template<Set set>
 void MoveGenerator::generateAllMoves() {
     const size_t setIndx = static_cast<size_t>(set);
-    if (m_moveMasks[setIndx].combine().empty()) {
+    if (m_position.empty()) {
         m_movesGenerated = true;
         return;
     }
 
-    if (m_pinThreats->isCheckedCount() > 1) {
-        generateMoves<set, kingId>(m_pinThreats[setIndx]);
+    if (m_checkers[setIndx].empty() == false) {
+        generateEvasions<set>();
     }
     else {
-        generateMoves<set, pawnId>(m_pinThreats[setIndx]);
-        generateMoves<set, knightId>(m_pinThreats[setIndx]);
-        generateMoves<set, bishopId>(m_pinThreats[setIndx]);
-        generateMoves<set, rookId>(m_pinThreats[setIndx]);
-        generateMoves<set, queenId>(m_pinThreats[setIndx]);
-        generateMoves<set, kingId>(m_pinThreats[setIndx]);
+        generateMoves<set, pawnId>();
+        generateMoves<set, knightId>();
+        generateMoves<set, bishopId>();
+        generateMoves<set, rookId>();
+        generateMoves<set, queenId>();
+        generateMoves<set, kingId>();
     }
-    sortMoves();
+    scoreMoves();
     m_movesGenerated = true;
 }
 
-void MoveGenerator::sortMoves() {
+template<Set set>
+void MoveGenerator::generateEvasions() {
+    constexpr u8 setIndx = static_cast<u8>(set);
+    constexpr u8 opIndx = static_cast<u8>(opposing_set<set>());
+    generateMoves<set, kingId>();
+
+    // in double check only the king can move.
+    if (m_checkers[setIndx].count() > 1)
+        return;
+
+    const auto& material = m_position.readMaterial();
+    const u64 occupancy = material.combine().read();
+    const Bitboard unoccupied(~occupancy);
+
+    // a pinned piece can neither capture the checker nor step in front of it without leaving its ray.
+    Bitboard movable = material.combine<set>() & ~material.kings<set>() & ~m_pinned[setIndx];
+    if (m_pieceType != PieceType::NONE)
+        movable &= material.read<set>(toPieceId(m_pieceType));
+
+    const Bitboard pawns = material.pawns<set>() & movable;
+    const Bitboard knights = material.knights<set>() & movable;
+    const Bitboard diagonal = (material.bishops<set>() | material.queens<set>()) & movable;
+    const Bitboard orthogonal = (material.rooks<set>() | material.queens<set>()) & movable;
+
+    Bitboard targets = calcTargetMask<set>();
+    while (targets.empty() == false) {
+        const u8 dstSqr = static_cast<u8>(targets.popLsb());
+        const Bitboard dstMask = squareMaskTable[dstSqr];
+        const bool capture = (m_checkers[setIndx] & dstMask).empty() == false;
+
+        Bitboard movers = Bitboard(attacks::getKnightAttacks(dstSqr)) & knights;
+        movers |= Bitboard(attacks::getBishopAttacks(dstSqr, occupancy)) & diagonal;
+        movers |= Bitboard(attacks::getRookAttacks(dstSqr, occupancy)) & orthogonal;
+        while (movers.empty() == false) {
+            const i32 srcSqr = movers.popLsb();
+            const u8 pieceId = m_position.readPieceAt(static_cast<Square>(srcSqr)).index();
+            genPackedMovesFromBitboard(pieceId, dstMask, srcSqr, capture);
+        }
+
+        Bitboard pawnMovers;
+        if (capture) {
+            pawnMovers = Bitboard(attacks::getPawnAttacks(opIndx, dstSqr)) & pawns;
+        }
+        else {
+            const Bitboard singlePush = dstMask.shiftSouthRelative<set>();
+            pawnMovers = singlePush & pawns;
+            if ((singlePush & unoccupied & pawn_constants::baseRank[setIndx]).empty() == false)
+                pawnMovers |= singlePush.shiftSouthRelative<set>() & pawns;
+        }
+
+        while (pawnMovers.empty() == false) {
+            PackedMove move;
+            move.setSource(static_cast<u16>(pawnMovers.popLsb()));
+            move.setTarget(static_cast<u16>(dstSqr));
+            move.setCapture(capture);
+            internalBuildPawnMove<set>(move, dstSqr);
+        }
+    }
+
+    // the pawn which just pushed two squares might be the checker, or its passing square might
+    // block the check, either way taking it en passant is verified against the board after.
+    const EnPassantStateInfo enPassant = m_position.readEnPassant();
+    if (enPassant && m_moveTypes != MoveTypes::CAPTURES_ONLY) {
+        const u8 epSqr = static_cast<u8>(enPassant.readSquare());
+        Bitboard capturers = Bitboard(attacks::getPawnAttacks(opIndx, epSqr)) & material.pawns<set>();
+        if (m_pieceType != PieceType::NONE && m_pieceType != PieceType::PAWN)
+            capturers = Bitboard();
+
+        while (capturers.empty() == false) {
+            const u8 srcSqr = static_cast<u8>(capturers.popLsb());
+            if (isLegalEnPassant<set>(srcSqr) == false)
+                continue;
+
+            PackedMove move;
+            move.setSource(static_cast<u16>(srcSqr));
+            move.setTarget(static_cast<u16>(epSqr));
+            move.setEnPassant(true);
+            internalBuildPawnMove<set>(move, epSqr);
+        }
+    }
+}
+
+template void MoveGenerator::generateEvasions<Set::WHITE>();
+template void MoveGenerator::generateEvasions<Set::BLACK>();
+
+void MoveGenerator::scoreMoves() {
     if (m_tt != nullptr) {
         PackedMove pv = m_tt->probe(m_hashKey);
         if (pv != PackedMove::NullMove()) {
-            auto itrMv = std::find_if(m_movesBuffer.begin(), m_movesBuffer.begin() + m_moveCount, [&](const PrioratizedMove& pm) {
+            auto itrMv = std::find_if(m_moves.begin(), m_moves.end(), [&](const PrioratizedMove& pm) {
                 return pm.move == pv;
                 });
 
-            if (itrMv != m_movesBuffer.end()) {
+            if (itrMv != m_moves.end()) {
                 itrMv->priority += move_generator_constants::pvMovePriority;
             }
         }
     }
 
     if (m_search != nullptr) {
-        for (u32 i = 0; i < m_moveCount; ++i) {
-            auto& move = m_movesBuffer[i];
+        for (auto& move : m_moves) {
             if (m_search->isKillerMove(move.move, m_ply)) {
                 move.priority += move_generator_constants::killerMovePriority;
                 move.priority += m_search->getHistoryHeuristic(static_cast<u8>(m_toMove), move.move.source(), move.move.target());
             }
         }
     }
-
-    PrioratizedMoveComparator comparator;
-    std::sort(m_movesBuffer.begin(), m_movesBuffer.begin() + m_moveCount, comparator);
 }
 
-void MoveGenerator::forEachMove(std::function<void(const PrioratizedMove&)> callback) const {
-    if (m_movesGenerated == false)
-        LOG_ERROR() << "Moves have not been generated yet.";
+void MoveGenerator::internalBuildPawnPromotionMoves(PackedMove move)
+{
+    const u16 promotionPriorityValue = move_generator_constants::promotionPriority << u8(move.isCapture());
 
-    for (uint16_t i = 0; i < m_moveCount; i++) {
-        callback(m_movesBuffer[i]);
+    for (u16 pieceId : { queenId, rookId, bishopId, knightId }) {
+        move.setPromoteTo(pieceId);
+        PrioratizedMove prioratizedMove(move, promotionPriorityValue);
+        prioratizedMove.setCheck(m_position.givesCheck(move, m_checkInfo));
+        m_moves.push(prioratizedMove);
     }
 }
 
-void MoveGenerator::internalBuildPawnPromotionMoves(PackedMove move, const KingPinThreats& pinThreats, i32 dstSqr)
-{
-    bool orthogonallyChecked = !(pinThreats.readOpponentOpenAngles()[0] & squareMaskTable[dstSqr]).empty();
-    bool diagonallyChecked = !(pinThreats.readOpponentOpenAngles()[1] & squareMaskTable[dstSqr]).empty();
-
-    u16 promotionPriorityValue = move_generator_constants::promotionPriority << u8(move.isCapture());
-
-    move.setPromoteTo(queenId);
-    PrioratizedMove queenPromote(move, 0);
-    queenPromote.setCheck(orthogonallyChecked || diagonallyChecked);
-    queenPromote.priority = promotionPriorityValue;
-
-    m_movesBuffer[m_moveCount] = queenPromote;
-    m_moveCount++;
-
-    move.setPromoteTo(rookId);
-    PrioratizedMove rookPromote(move, 1);
-    rookPromote.setCheck(orthogonallyChecked);
-    rookPromote.priority = promotionPriorityValue;
-    m_movesBuffer[m_moveCount] = rookPromote;
-    m_moveCount++;
-
-    move.setPromoteTo(bishopId);
-    PrioratizedMove bishopPromote(move, 1);
-    bishopPromote.setCheck(diagonallyChecked);
-    bishopPromote.priority = promotionPriorityValue;
-    m_movesBuffer[m_moveCount] = bishopPromote;
-    m_moveCount++;
-
-    // don't I need to check for check here?
-    move.setPromoteTo(knightId);
-    PrioratizedMove knigthPromote(move, 1);
-    knigthPromote.priority = promotionPriorityValue;
-    m_movesBuffer[m_moveCount] = knigthPromote;
-    m_moveCount++;
-}
-
 template<Set set>
 void
-MoveGenerator::internalGeneratePawnMoves(const KingPinThreats& pinThreats)
+MoveGenerator::internalGeneratePawnMoves()
 {
-    const auto& pos = m_position;
+    if (m_pieceType != PieceType::NONE && m_pieceType != PieceType::PAWN)
+        return;
 
-    const Bitboard movesbb = m_moveMasks[(size_t)set].material[pawnId];
-    if (movesbb.empty())
+    const auto& material = m_position.readMaterial();
+    Bitboard pawns = material.pawns<set>();
+    if (pawns.empty())
         return;
 
-    // cache pawns in local variable which we'll use to iterate over all pawns.
-    Bitboard pawns = pos.readMaterial().pawns<set>();
+    constexpr u8 setIndx = static_cast<u8>(set);
+    const Bitboard opMaterial = material.combine<opposing_set<set>()>();
+    const Bitboard unoccupied = ~material.combine();
+    const Bitboard targets = calcTargetMask<set>();
+
+    // the pawn taken en passant isn't on the target square, so it's not part of the capture only moves.
+    const EnPassantStateInfo enPassant = m_position.readEnPassant();
+    const Bitboard enPassantMask = m_moveTypes == MoveTypes::CAPTURES_ONLY ? Bitboard() : enPassant.readBitboard();
 
     while (pawns.empty() == false) {
-        // build source square and remove pawn from pawns bitboard.
         const i32 srcSqr = pawns.popLsb();
-        const Notation srcNotation(srcSqr);
-
-        const u64 promotionMask = pawn_constants::promotionRank[(size_t)set];
+        const Bitboard srcMask = squareMaskTable[srcSqr];
+        const Bitboard pawnAttacks = attacks::getPawnAttacks(setIndx, static_cast<u8>(srcSqr));
+
+        Bitboard pushes = srcMask.shiftNorthRelative<set>() & unoccupied;
+        pushes |= (pushes & pawn_constants::baseRank[setIndx]).shiftNorthRelative<set>() & unoccupied;
+        pushes &= targets;
+        Bitboard captures = pawnAttacks & opMaterial & targets;
+
+        const Bitboard pinRay = calcPinRay<set>(static_cast<u8>(srcSqr));
+        if (pinRay.empty() == false) {
+            pushes &= pinRay;
+            captures &= pinRay;
+        }
 
-        auto [isolatedPawnMoves, isolatedPawnAttacks] = pos.isolatePiece<set, pawnId>(srcNotation, movesbb, pinThreats);
-        while (isolatedPawnAttacks.empty() == false) {
-            i32 dstSqr = isolatedPawnAttacks.popLsb();
+        if ((pawnAttacks & enPassantMask).empty() == false && isLegalEnPassant<set>(static_cast<u8>(srcSqr)))
+            captures |= enPassantMask;
 
-            PrioratizedMove prioratizedMove;
-            PackedMove& move = prioratizedMove.move;
+        while (captures.empty() == false) {
+            const i32 dstSqr = captures.popLsb();
+            PackedMove move;
             move.setSource(srcSqr);
             move.setTarget(dstSqr);
-
-            prioratizedMove.priority = move_generator_constants::capturePriority;
-
-            // if we're capturing enpassant set the enpassant flag.
-            if (pos.readEnPassant().readSquare() == static_cast<Square>(dstSqr))
+            if (enPassant.readSquare() == static_cast<Square>(dstSqr))
                 move.setEnPassant(true);  // sets both capture & enpassant
             else
                 move.setCapture(true);
 
-            // if we're promoting set the promotion flag and create 4 moves.
-            if (promotionMask & squareMaskTable[dstSqr]) {
-                internalBuildPawnPromotionMoves(move, pinThreats, dstSqr);
-            }
-            else {
-                Position checkedPos;
-                checkedPos.PlacePiece(ChessPiece(set, PieceType::PAWN), static_cast<Square>(dstSqr));
-                auto threat = checkedPos.calcThreatenedSquaresPawnBulk<set>();
-                if (threat & pos.readMaterial().kings<opposing_set<set>()>()) {
-                    prioratizedMove.setCheck(true);
-                    prioratizedMove.priority += move_generator_constants::checkPriority;
-                }
-
-
-                m_movesBuffer[m_moveCount] = prioratizedMove;
-                m_moveCount++;
-            }
+            internalBuildPawnMove<set>(move, dstSqr);
         }
-        while (isolatedPawnMoves.empty() == false) {
-            i32 dstSqr = isolatedPawnMoves.popLsb();
 
-            PrioratizedMove prioratizedMove;
-            PackedMove& move = prioratizedMove.move;
+        while (pushes.empty() == false) {
+            const i32 dstSqr = pushes.popLsb();
+            PackedMove move;
             move.setSource(srcSqr);
             move.setTarget(dstSqr);
-
-            // if we're promoting set the promotion flag and create 4 moves.
-            if (promotionMask & squareMaskTable[dstSqr]) {
-                internalBuildPawnPromotionMoves(move, pinThreats, dstSqr);
-            }
-            else {
-                Position checkedPos;
-                checkedPos.PlacePiece(ChessPiece(set, PieceType::PAWN), static_cast<Square>(dstSqr));
-                auto threat = checkedPos.calcThreatenedSquaresPawnBulk<set>();
-                if (threat & pos.readMaterial().kings<opposing_set<set>()>()) {
-                    prioratizedMove.setCheck(true);
-                    prioratizedMove.priority += move_generator_constants::checkPriority;
-                }
-
-                m_movesBuffer[m_moveCount] = prioratizedMove;
-                m_moveCount++;
-            }
+            internalBuildPawnMove<set>(move, dstSqr);
         }
     }
 }
 
-template void MoveGenerator::internalGeneratePawnMoves<Set::WHITE>(const KingPinThreats& pinThreats);
-template void MoveGenerator::internalGeneratePawnMoves<Set::BLACK>(const KingPinThreats& pinThreats);
+template void MoveGenerator::internalGeneratePawnMoves<Set::WHITE>();
+template void MoveGenerator::internalGeneratePawnMoves<Set::BLACK>();
 
 template<Set set>
 void
-MoveGenerator::internalGenerateMoves(u8 pieceId, const KingPinThreats& pinThreats)
+MoveGenerator::internalBuildPawnMove(PackedMove move, i32 dstSqr)
 {
-    const auto& bb = m_position;
+    constexpr u8 setIndx = static_cast<u8>(set);
+    // if we're promoting create 4 moves.
+    if (pawn_constants::promotionRank[setIndx] & squareMaskTable[dstSqr]) {
+        internalBuildPawnPromotionMoves(move);
+        return;
+    }
 
-    const Bitboard movesbb = m_moveMasks[(size_t)set].material[pieceId];
-    if (movesbb.empty())
+    PrioratizedMove prioratizedMove(move, move.isCapture() ? move_generator_constants::capturePriority : 0);
+    if (m_position.givesCheck(move, m_checkInfo)) {
+        prioratizedMove.setCheck(true);
+        prioratizedMove.priority += move_generator_constants::checkPriority;
+    }
+
+    m_moves.push(prioratizedMove);
+}
+
+template void MoveGenerator::internalBuildPawnMove<Set::WHITE>(PackedMove, i32);
+template void MoveGenerator::internalBuildPawnMove<Set::BLACK>(PackedMove, i32);
+
+template<Set set>
+bool
+MoveGenerator::isLegalEnPassant(u8 srcSqr) const
+{
+    const auto& material = m_position.readMaterial();
+    const Bitboard king = material.kings<set>();
+    if (king.empty())
+        return true;
+
+    const EnPassantStateInfo enPassant = m_position.readEnPassant();
+    Bitboard occupancy = material.combine();
+    occupancy ^= squareMaskTable[srcSqr];
+    occupancy ^= squareMaskTable[static_cast<u8>(enPassant.readTarget())];
+    occupancy |= enPassant.readBitboard();
+
+    // the captured pawn is no longer in the occupancy, so it doesn't count as an attacker.
+    const Bitboard attackers = m_position.calcAttackersTo(static_cast<Square>(king.lsbIndex()), occupancy);
+    return (attackers & material.combine<opposing_set<set>()>()).empty();
+}
+
+template bool MoveGenerator::isLegalEnPassant<Set::WHITE>(u8) const;
+template bool MoveGenerator::isLegalEnPassant<Set::BLACK>(u8) const;
+
+template<Set set>
+Bitboard
+MoveGenerator::calcTargetMask() const
+{
+    const auto& material = m_position.readMaterial();
+    Bitboard targets = ~material.combine<set>();
+    if (m_moveTypes == MoveTypes::CAPTURES_ONLY)
+        targets &= material.combine<opposing_set<set>()>();
+
+    // with a single checker we have to capture it or block the ray it's checking along.
+    const Bitboard checkers = m_checkers[static_cast<u8>(set)];
+    if (checkers.empty() == false) {
+        const u8 kingSqr = static_cast<u8>(material.kings<set>().lsbIndex());
+        targets &= Bitboard(ray::getRay(kingSqr, static_cast<u8>(checkers.lsbIndex()))) | checkers;
+    }
+
+    return targets;
+}
+
+template Bitboard MoveGenerator::calcTargetMask<Set::WHITE>() const;
+template Bitboard MoveGenerator::calcTargetMask<Set::BLACK>() const;
+
+template<Set set>
+Bitboard
+MoveGenerator::calcPinRay(u8 sqr) const
+{
+    constexpr u8 setIndx = static_cast<u8>(set);
+    const Bitboard sqrMask = squareMaskTable[sqr];
+    if ((m_pinned[setIndx] & sqrMask).empty())
+        return Bitboard();
+
+    const u8 kingSqr = static_cast<u8>(m_position.readMaterial().kings<set>().lsbIndex());
+    Bitboard pinners = m_pinners[setIndx];
+    while (pinners.empty() == false) {
+        const Bitboard pinRay(ray::getRay(kingSqr, static_cast<u8>(pinners.popLsb())));
+        if (pinRay & sqrMask)
+            return pinRay;
+    }
+    return Bitboard();
+}
+
+template Bitboard MoveGenerator::calcPinRay<Set::WHITE>(u8) const;
+template Bitboard MoveGenerator::calcPinRay<Set::BLACK>(u8) const;
+
+template<Set set>
+void
+MoveGenerator::calcKingSafety() const
+{
+    constexpr u8 setIndx = static_cast<u8>(set);
+    if (m_kingSafetyComputed[setIndx])
+        return;
+
+    std::tie(m_checkers[setIndx], m_pinners[setIndx], m_pinned[setIndx]) = m_position.calcCheckersAndPins(set);
+    m_kingSafetyComputed[setIndx] = true;
+}
+
+template void MoveGenerator::calcKingSafety<Set::WHITE>() const;
+template void MoveGenerator::calcKingSafety<Set::BLACK>() const;
+
+template<Set set, u8 pieceId>
+void
+MoveGenerator::internalGenerateMoves()
+{
+    if (m_pieceType != PieceType::NONE && toPieceId(m_pieceType) != pieceId)
         return;
 
-    Bitboard pieces = bb.readMaterial().read<set>(pieceId);
+    const auto& material = m_position.readMaterial();
+    Bitboard pieces = material.read<set, pieceId>();
+    if (pieces.empty())
+        return;
+
+    const u64 occupancy = material.combine().read();
+    const Bitboard opMaterial = material.combine<opposing_set<set>()>();
+    const Bitboard targets = calcTargetMask<set>();
 
     while (pieces.empty() == false) {
-        // build source square and remove knight from cached material bitboard.
         const i32 srcSqr = pieces.popLsb();
-        const Notation srcNotation(srcSqr);
 
-        auto [isolatedMoves, isolatedCaptures] = bb.isolatePiece<set>(pieceId, srcNotation, movesbb, pinThreats);
-        genPackedMovesFromBitboard(static_cast<u8>(set), pieceId, isolatedCaptures, srcSqr, /*are captures*/ true, pinThreats);
-        genPackedMovesFromBitboard(static_cast<u8>(set), pieceId, isolatedMoves, srcSqr, /*are captures*/ false, pinThreats);
+        // attacks straight from the magic tables, no need to isolate the piece from a bulk mask.
+        Bitboard movesbb;
+        if constexpr (pieceId == knightId)
+            movesbb = attacks::getKnightAttacks(srcSqr);
+        else if constexpr (pieceId == bishopId)
+            movesbb = attacks::getBishopAttacks(srcSqr, occupancy);
+        else if constexpr (pieceId == rookId)
+            movesbb = attacks::getRookAttacks(srcSqr, occupancy);
+        else
+            movesbb = attacks::getBishopAttacks(srcSqr, occupancy) | attacks::getRookAttacks(srcSqr, occupancy);
+        movesbb &= targets;
+
+        // a pinned piece can only move along the ray between our king and the pinning piece.
+        const Bitboard pinRay = calcPinRay<set>(static_cast<u8>(srcSqr));
+        if (pinRay.empty() == false)
+            movesbb &= pinRay;
+
+        genPackedMovesFromBitboard(pieceId, movesbb & opMaterial, srcSqr, /*are captures*/ true);
+        genPackedMovesFromBitboard(pieceId, movesbb & ~opMaterial, srcSqr, /*are captures*/ false);
     }
 }
 
-template void MoveGenerator::internalGenerateMoves<Set::WHITE>(u8, const KingPinThreats&);
-template void MoveGenerator::internalGenerateMoves<Set::BLACK>(u8, const KingPinThreats&);
-
 template<Set set>
 void
-MoveGenerator::internalGenerateKnightMoves(const KingPinThreats& pinThreats)
+MoveGenerator::internalGenerateKnightMoves()
 {
-    internalGenerateMoves<set>(knightId, pinThreats);
+    internalGenerateMoves<set, knightId>();
 }
 
-template void MoveGenerator::internalGenerateKnightMoves<Set::WHITE>(const KingPinThreats& pinThreats);
-template void MoveGenerator::internalGenerateKnightMoves<Set::BLACK>(const KingPinThreats& pinThreats);
+template void MoveGenerator::internalGenerateKnightMoves<Set::WHITE>();
+template void MoveGenerator::internalGenerateKnightMoves<Set::BLACK>();
 
 template<Set set>
 void
-MoveGenerator::internalGenerateBishopMoves(const KingPinThreats& pinThreats)
+MoveGenerator::internalGenerateBishopMoves()
 {
-    internalGenerateMoves<set>(bishopId, pinThreats);
+    internalGenerateMoves<set, bishopId>();
 }
 
-template void MoveGenerator::internalGenerateBishopMoves<Set::WHITE>(const KingPinThreats& pinThreats);
-template void MoveGenerator::internalGenerateBishopMoves<Set::BLACK>(const KingPinThreats& pinThreats);
+template void MoveGenerator::internalGenerateBishopMoves<Set::WHITE>();
+template void MoveGenerator::internalGenerateBishopMoves<Set::BLACK>();
 
 template<Set set>
 void
-MoveGenerator::internalGenerateRookMoves(const KingPinThreats& pinThreats)
+MoveGenerator::internalGenerateRookMoves()
 {
-    internalGenerateMoves<set>(rookId, pinThreats);
+    internalGenerateMoves<set, rookId>();
 }
 
-template void MoveGenerator::internalGenerateRookMoves<Set::WHITE>(const KingPinThreats& pinThreats);
-template void MoveGenerator::internalGenerateRookMoves<Set::BLACK>(const KingPinThreats& pinThreats);
+template void MoveGenerator::internalGenerateRookMoves<Set::WHITE>();
+template void MoveGenerator::internalGenerateRookMoves<Set::BLACK>();
 
 template<Set set>
 void
-MoveGenerator::internalGenerateQueenMoves(const KingPinThreats& pinThreats)
+MoveGenerator::internalGenerateQueenMoves()
 {
-    internalGenerateMoves<set>(queenId, pinThreats);
+    internalGenerateMoves<set, queenId>();
 }
 
-template void MoveGenerator::internalGenerateQueenMoves<Set::WHITE>(const KingPinThreats& pinThreats);
-template void MoveGenerator::internalGenerateQueenMoves<Set::BLACK>(const KingPinThreats& pinThreats);
+template void MoveGenerator::internalGenerateQueenMoves<Set::WHITE>();
+template void MoveGenerator::internalGenerateQueenMoves<Set::BLACK>();
 
 template<Set set>
 void
@@ -368,7 +556,7 @@ MoveGenerator::internalGenerateKingMoves()
     const Bitboard opMaterial = bb.readMaterial().combine<opposing_set<set>()>();
     const u8 setId = static_cast<u8>(set);
 
-    Bitboard movesbb = m_moveMasks[setId].material[kingId];
+    Bitboard movesbb = m_kingMoves;
 #if defined EG_DEBUGGING || defined EG_TESTING
     // during testing and debugging king can be missing
     if (movesbb.empty())
@@ -405,8 +593,13 @@ MoveGenerator::internalGenerateKingMoves()
             }
         }
 
-        m_movesBuffer[m_moveCount] = prioratizedMove;
-        m_moveCount++;
+        // the king only checks by uncovering a slider or through the rook when castling.
+        if (m_position.givesCheck(move, m_checkInfo)) {
+            prioratizedMove.setCheck(true);
+            prioratizedMove.priority += move_generator_constants::checkPriority;
+        }
+
+        m_moves.push(prioratizedMove);
     }
 }
 
@@ -420,69 +613,40 @@ MoveGenerator::initializeMoveGenerator(PieceType ptype, MoveTypes mtype) {
     if (bb.empty())
         return;
 
-    m_pinThreats[0] = bb.calcKingMask<Set::WHITE>();
-    m_pinThreats[1] = bb.calcKingMask<Set::BLACK>();
-
-    if (captures) {
-        initializeMoveMasks<Set::WHITE, true>(m_moveMasks[0], ptype);
-        initializeMoveMasks<Set::BLACK, true>(m_moveMasks[1], ptype);
+    if (m_toMove == Set::WHITE) {
+        if (captures)
+            initializeMoveMasks<Set::WHITE, true>(ptype);
+        else
+            initializeMoveMasks<Set::WHITE, false>(ptype);
     }
     else {
-        initializeMoveMasks<Set::WHITE, false>(m_moveMasks[0], ptype);
-        initializeMoveMasks<Set::BLACK, false>(m_moveMasks[1], ptype);
+        if (captures)
+            initializeMoveMasks<Set::BLACK, true>(ptype);
+        else
+            initializeMoveMasks<Set::BLACK, false>(ptype);
     }
 }
 
 template<Set set, bool captures>
-void MoveGenerator::initializeMoveMasks(MaterialMask& target, PieceType ptype) {
+void MoveGenerator::initializeMoveMasks(PieceType ptype) {
     const auto& bb = m_position;
-    if (bb.empty())
-        return;
-    const size_t setIndx = static_cast<size_t>(set);
+    calcKingSafety<set>();
+    m_checkInfo = bb.calcCheckInfo<set>();
 
-    if (ptype == PieceType::NONE) {
-        target.material[pawnId] = bb.calcAvailableMovesPawnBulk<set, captures>(m_pinThreats[setIndx]);
-        target.material[knightId] = bb.calcAvailableMovesKnightBulk<set, captures>(m_pinThreats[setIndx]);
-        target.material[bishopId] = bb.calcAvailableMovesBishopBulk<set, captures>(m_pinThreats[setIndx]);
-        target.material[rookId] = bb.calcAvailableMovesRookBulk<set, captures>(m_pinThreats[setIndx]);
-        target.material[queenId] = bb.calcAvailableMovesQueenBulk<set, captures>(m_pinThreats[setIndx]);
-        target.material[kingId] = bb.calcAvailableMovesKing<set, captures>(bb.readCastling().read());
-    }
-    else {
-        switch (ptype) {
-        case PieceType::PAWN:
-            target.material[pawnId] = bb.calcAvailableMovesPawnBulk<set, captures>(m_pinThreats[setIndx]);
-            break;
-        case PieceType::KNIGHT:
-            target.material[knightId] = bb.calcAvailableMovesKnightBulk<set, captures>(m_pinThreats[setIndx]);
-            break;
-        case PieceType::BISHOP:
-            target.material[bishopId] = bb.calcAvailableMovesBishopBulk<set, captures>(m_pinThreats[setIndx]);
-            break;
-        case PieceType::ROOK:
-            target.material[rookId] = bb.calcAvailableMovesRookBulk<set, captures>(m_pinThreats[setIndx]);
-            break;
-        case PieceType::QUEEN:
-            target.material[queenId] = bb.calcAvailableMovesQueenBulk<set, captures>(m_pinThreats[setIndx]);
-            break;
-        case PieceType::KING:
-            target.material[kingId] = bb.calcAvailableMovesKing<set, captures>(bb.readCastling().read());
-            break;
-        default:
-            FATAL_ASSERT(false) << "Invalid piece type";
-            break;
-        }
-    }
+    if (ptype == PieceType::NONE || ptype == PieceType::KING)
+        m_kingMoves = bb.calcAvailableMovesKing<set, captures>(bb.readCastling().read(), m_attackMaps.bySet(opposing_set<set>()));
 }
 
-template void MoveGenerator::initializeMoveMasks<Set::WHITE, true>(MaterialMask& target, PieceType ptype);
-template void MoveGenerator::initializeMoveMasks<Set::BLACK, true>(MaterialMask& target, PieceType ptype);
-template void MoveGenerator::initializeMoveMasks<Set::WHITE, false>(MaterialMask& target, PieceType ptype);
-template void MoveGenerator::initializeMoveMasks<Set::BLACK, false>(MaterialMask& target, PieceType ptype);
+template void MoveGenerator::initializeMoveMasks<Set::WHITE, true>(PieceType ptype);
+template void MoveGenerator::initializeMoveMasks<Set::BLACK, true>(PieceType ptype);
+template void MoveGenerator::initializeMoveMasks<Set::WHITE, false>(PieceType ptype);
+template void MoveGenerator::initializeMoveMasks<Set::BLACK, false>(PieceType ptype);
 
 void
-MoveGenerator::genPackedMovesFromBitboard(u8 setId, u8 pieceId, Bitboard movesbb, i32 srcSqr, bool capture, const KingPinThreats& pinThreats)
+MoveGenerator::genPackedMovesFromBitboard(u8 pieceId, Bitboard movesbb, i32 srcSqr, bool capture)
 {
+    const Bitboard directChecks = movesbb & m_checkInfo.checkSquares[pieceId];
+    const bool discoverer = (m_checkInfo.discoverers & squareMaskTable[srcSqr]).empty() == false;
     while (movesbb.empty() == false) {
         i32 dstSqr = movesbb.popLsb();
 
@@ -491,29 +655,14 @@ MoveGenerator::genPackedMovesFromBitboard(u8 setId, u8 pieceId, Bitboard movesbb
         move.setSource(static_cast<Square>(srcSqr));
         move.setTarget(static_cast<Square>(dstSqr));
         move.setCapture(capture);
-        prioratizedMove.priority = 0;
-
-        if (capture) {
-            const u8 opId = opposing_set(setId);
-            u8 recaptureBonus = ((m_moveMasks[opId].combine() & squareMaskTable[dstSqr]).empty() == false) ? 2 : 1;
-            prioratizedMove.priority = move_generator_constants::capturePriority * u8(capture) * recaptureBonus;
-        }
+        prioratizedMove.priority = capture ? move_generator_constants::capturePriority : 0;
 
-        // figure out if we're checking the king.
-        if (pieceId == rookId || pieceId == queenId) {
-            if (pinThreats.readOpponentOpenAngles()[0] & squareMaskTable[dstSqr]) {
-                prioratizedMove.setCheck(true);
-                prioratizedMove.priority += move_generator_constants::checkPriority;
-            }
-        }
-        else if (pieceId == bishopId || pieceId == queenId) {
-            if (pinThreats.readOpponentOpenAngles()[1] & squareMaskTable[dstSqr]) {
-                prioratizedMove.setCheck(true);
-                prioratizedMove.priority += move_generator_constants::checkPriority;
-            }
+        // figure out if we're checking the king, directly or by getting out of the way of a slider.
+        if ((directChecks & squareMaskTable[dstSqr]) || (discoverer && m_position.givesCheck(move, m_checkInfo))) {
+            prioratizedMove.setCheck(true);
+            prioratizedMove.priority += move_generator_constants::checkPriority;
         }
-        m_movesBuffer[m_moveCount] = prioratizedMove;
-        m_moveCount++;
+        m_moves.push(prioratizedMove);
     }
 }
 
@@ -521,7 +670,7 @@ bool
 MoveGenerator::isChecked() const
 {
     if (m_toMove == Set::WHITE)
-        return m_pinThreats[0].isCheckedCount() > 0;
+        return isChecked<Set::WHITE>();
     else
-        return m_pinThreats[1].isCheckedCount() > 0;
+        return isChecked<Set::BLACK>();
 }
\ No newline at end of file
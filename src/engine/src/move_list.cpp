@@ -0,0 +1,23 @@
+#include "move_list.hpp"
+
+MoveArena::MoveArena() :
+    m_depth(0)
+{
+    m_slots.reserve(move_list_constants::preallocatedSlots);
+    for (u16 i = 0; i < move_list_constants::preallocatedSlots; ++i)
+        m_slots.push_back(std::make_unique<Slot>());
+}
+
+MoveArena& MoveArena::local()
+{
+    thread_local MoveArena arena;
+    return arena;
+}
+
+PrioratizedMove* MoveArena::acquire()
+{
+    if (m_depth == m_slots.size())
+        m_slots.push_back(std::make_unique<Slot>());
+
+    return m_slots[m_depth++]->data();
+}
@@ -0,0 +1,137 @@
+#include "numa.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace numa {
+
+std::vector<u32> parseCpuList(const std::string& cpuList)
+{
+    std::vector<u32> cpus;
+    std::stringstream ss(cpuList);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)) != 0; }),
+                    range.end());
+        if (range.empty())
+            continue;
+
+        auto dash = range.find('-');
+        u32 first = std::stoul(range.substr(0, dash));
+        u32 last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+        for (u32 cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+const Topology& Topology::Instance()
+{
+    static Topology instance("/sys/devices/system/node");
+    return instance;
+}
+
+Topology::Topology(const std::string& nodeDirectory)
+{
+    namespace fs = std::filesystem;
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(nodeDirectory, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind("node", 0) != 0 || name.size() == 4
+            || std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)) != 0; }) == false)
+            continue;
+
+        std::ifstream file(entry.path() / "cpulist");
+        std::string cpuList;
+        std::getline(file, cpuList);
+
+        Node node;
+        node.id = std::stoul(name.substr(4));
+        node.cpus = parseCpuList(cpuList);
+        // memory only nodes have no cpus to bind threads to.
+        if (node.cpus.empty() == false)
+            m_nodes.push_back(std::move(node));
+    }
+
+    if (m_nodes.empty()) {
+        Node node;
+        const u32 cpuCount = std::max(1u, std::thread::hardware_concurrency());
+        for (u32 cpu = 0; cpu < cpuCount; ++cpu)
+            node.cpus.push_back(cpu);
+        m_nodes.push_back(std::move(node));
+    }
+
+    std::sort(m_nodes.begin(), m_nodes.end(), [](const Node& lhs, const Node& rhs) { return lhs.id < rhs.id; });
+}
+
+u32 Topology::readCpuCount() const
+{
+    u32 count = 0;
+    for (const auto& node : m_nodes)
+        count += static_cast<u32>(node.cpus.size());
+    return count;
+}
+
+const Node& Topology::nodeForThread(u32 threadIndex) const
+{
+    return m_nodes[threadIndex % m_nodes.size()];
+}
+
+u32 Topology::cpuForThread(u32 threadIndex) const
+{
+    const Node& node = nodeForThread(threadIndex);
+    return node.cpus[(threadIndex / m_nodes.size()) % node.cpus.size()];
+}
+
+bool bindThread(u32 threadIndex)
+{
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(Topology::Instance().cpuForThread(threadIndex), &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &set) == 0;
+#else
+    (void)threadIndex;
+    return false;
+#endif
+}
+
+void parallelFill(void* data, size_t bytes, u32 threads, Placement placement)
+{
+    if (threads <= 1) {
+        std::memset(data, 0, bytes);
+        return;
+    }
+
+    byte* begin = static_cast<byte*>(data);
+    std::vector<std::thread> workers;
+    for (u32 threadIndex = 0; threadIndex < threads; ++threadIndex) {
+        workers.emplace_back([=]() {
+            bindThread(threadIndex);
+            if (placement == Placement::FirstTouch) {
+                const size_t slice = (bytes + threads - 1) / threads;
+                const size_t offset = std::min(bytes, slice * threadIndex);
+                std::memset(begin + offset, 0, std::min(slice, bytes - offset));
+                return;
+            }
+
+            for (size_t offset = c_interleaveChunkSize * threadIndex; offset < bytes; offset += c_interleaveChunkSize * threads)
+                std::memset(begin + offset, 0, std::min(c_interleaveChunkSize, bytes - offset));
+        });
+    }
+
+    for (auto& worker : workers)
+        worker.join();
+}
+
+}  // namespace numa
@@ -1,10 +1,14 @@
 #include "position.hpp"
+#include <algorithm>
 #include <array>
+#include "attack_maps.hpp"
 #include "attacks/attacks.hpp"
 #include "bitboard.hpp"
 #include "chess_piece.h"
+#include "cpu.hpp"
 #include "log.h"
 #include "notation.h"
+#include "rays/rays.hpp"
 
 std::string
 CastlingStateInfo::toString() const
@@ -32,15 +36,6 @@ Position::Position() :
     m_materialMask = {};
 }
 
-Position&
-Position::operator=(const Position& other)
-{
-    m_materialMask = other.m_materialMask;
-    m_castlingState = other.m_castlingState;
-    m_enpassantState = other.m_enpassantState;
-    return *this;
-}
-
 bool
 Position::IsValidSquare(signed short currSqr)
 {
@@ -65,6 +60,7 @@ void
 Position::Clear()
 {
     m_materialMask.clear();
+    std::fill(std::begin(m_mailbox), std::end(m_mailbox), ChessPiece::None());
     m_enpassantState = {};
     m_castlingState = {};
 }
@@ -81,6 +77,7 @@ Position::ClearPiece(ChessPiece piece, Square target)
     Bitboard pieceMask;
     pieceMask[target] = true;
     m_materialMask.clear(pieceMask, piece.getSet(), piece.index());
+    m_mailbox[static_cast<u8>(target)] = ChessPiece::None();
     return true;
 }
 
@@ -90,42 +87,11 @@ Position::PlacePiece(ChessPiece piece, Square target)
     Bitboard piecebb;
     piecebb[target] = true;
     m_materialMask.write(piecebb, piece.getSet(), piece.index());
+    m_mailbox[static_cast<u8>(target)] = piece;
 
     return true;
 }
 
-ChessPiece
-Position::readPieceAt(Square sqr) const
-{
-    Bitboard mask(UINT64_C(1) << (u8)sqr);
-
-    for (byte set = 0; set < 2; ++set) {
-        if (m_materialMask.m_set[set] & mask)
-        {
-            // unrolled this for loop in an attempt to make it quicker.
-            if (m_materialMask.pawns() & mask)
-                return piece_constants::pieces[set][pawnId];
-            else if (m_materialMask.knights() & mask)
-                return piece_constants::pieces[set][knightId];
-            else if (m_materialMask.bishops() & mask)
-                return piece_constants::pieces[set][bishopId];
-            else if (m_materialMask.rooks() & mask)
-                return piece_constants::pieces[set][rookId];
-            else if (m_materialMask.queens() & mask)
-                return piece_constants::pieces[set][queenId];
-            else if (m_materialMask.kings() & mask)
-                return piece_constants::pieces[set][kingId];
-        }
-    }
-    return ChessPiece::None();
-}
-
-MutableMaterialProxy
-Position::materialEditor(Set set, PieceType pType)
-{
-    return MutableMaterialProxy(&m_materialMask.m_set[static_cast<i8>(set)], &m_materialMask.m_material[toPieceId(pType)]);
-}
-
 
 template<Set us>
 KingPinThreats Position::calcKingMask() const {
@@ -265,7 +231,18 @@ Position::calcAvailableMovesKing(byte castlingRights) const
 {
     bool constexpr includeMaterial = false;
     bool constexpr pierceKing = true;
-    Bitboard threatened = calcThreatenedSquares<op, includeMaterial, pierceKing>();
+    return calcAvailableMovesKing<us, captures, op>(castlingRights, calcThreatenedSquares<op, includeMaterial, pierceKing>());
+}
+
+template Bitboard Position::calcAvailableMovesKing<Set::WHITE, true, Set::BLACK>(byte) const;
+template Bitboard Position::calcAvailableMovesKing<Set::WHITE, false, Set::BLACK>(byte) const;
+template Bitboard Position::calcAvailableMovesKing<Set::BLACK, true, Set::WHITE>(byte) const;
+template Bitboard Position::calcAvailableMovesKing<Set::BLACK, false, Set::WHITE>(byte) const;
+
+template<Set us, bool captures, Set op>
+Bitboard
+Position::calcAvailableMovesKing(byte castlingRights, Bitboard threatened) const
+{
     Bitboard moves = calcThreatenedSquaresKing<us>();
     // remove any squares blocked by our own pieces.
     moves &= ~m_materialMask.combine<us>();
@@ -277,10 +254,10 @@ Position::calcAvailableMovesKing(byte castlingRights) const
     return moves;
 }
 
-template Bitboard Position::calcAvailableMovesKing<Set::WHITE, true, Set::BLACK>(byte) const;
-template Bitboard Position::calcAvailableMovesKing<Set::WHITE, false, Set::BLACK>(byte) const;
-template Bitboard Position::calcAvailableMovesKing<Set::BLACK, true, Set::WHITE>(byte) const;
-template Bitboard Position::calcAvailableMovesKing<Set::BLACK, false, Set::WHITE>(byte) const;
+template Bitboard Position::calcAvailableMovesKing<Set::WHITE, true, Set::BLACK>(byte, Bitboard) const;
+template Bitboard Position::calcAvailableMovesKing<Set::WHITE, false, Set::BLACK>(byte, Bitboard) const;
+template Bitboard Position::calcAvailableMovesKing<Set::BLACK, true, Set::WHITE>(byte, Bitboard) const;
+template Bitboard Position::calcAvailableMovesKing<Set::BLACK, false, Set::WHITE>(byte, Bitboard) const;
 
 template<Set us>
 Bitboard
@@ -660,4 +637,401 @@ Position::diffWestEast(Notation a, Notation b) const
     i32 a_flattened = mod_by_eight(a.index());
     i32 b_flattened = mod_by_eight(b.index());
     return b_flattened - a_flattened;
-}
\ No newline at end of file
+}
+Bitboard
+Position::calcAttackersTo(Square sqr, Bitboard occupancy) const
+{
+    const u8 sqrIndx = static_cast<u8>(sqr);
+    const Bitboard target = squareMaskTable[sqrIndx];
+    const Bitboard notFileA = ~board_constants::fileaMask;
+    const Bitboard notFileH = ~board_constants::filehMask;
+
+    // squares a pawn of respective set would have to stand on to attack sqr.
+    Bitboard whitePawnSqrs = (target.shiftSouthWest() & notFileH) | (target.shiftSouthEast() & notFileA);
+    Bitboard blackPawnSqrs = (target.shiftNorthWest() & notFileH) | (target.shiftNorthEast() & notFileA);
+
+    Bitboard kingSqrs = target.shiftNorth() | target.shiftSouth();
+    kingSqrs |= ((target | kingSqrs).shiftEast() & notFileA) | ((target | kingSqrs).shiftWest() & notFileH);
+
+    const Bitboard orthogonal = m_materialMask.rooks() | m_materialMask.queens();
+    const Bitboard diagonal = m_materialMask.bishops() | m_materialMask.queens();
+
+    Bitboard attackers = (whitePawnSqrs & m_materialMask.whitePawns()) | (blackPawnSqrs & m_materialMask.blackPawns());
+    attackers |= attacks::getKnightAttacks(sqrIndx) & m_materialMask.knights();
+    attackers |= kingSqrs & m_materialMask.kings();
+    attackers |= attacks::getRookAttacks(sqrIndx, occupancy.read()) & orthogonal;
+    attackers |= attacks::getBishopAttacks(sqrIndx, occupancy.read()) & diagonal;
+    return attackers & occupancy;
+}
+
+CPU_DISPATCH std::tuple<Bitboard, Bitboard, Bitboard>
+Position::calcCheckersAndPins(Set set) const
+{
+    const Bitboard king = m_materialMask.read(set, kingId);
+    if (king.empty())
+        return { 0, 0, 0 };
+
+    const u8 kingSqr = static_cast<u8>(king.lsbIndex());
+    const Bitboard occupancy = m_materialMask.combine();
+    const Bitboard opMaterial = m_materialMask.combine(static_cast<Set>(opposing_set(static_cast<u8>(set))));
+    const Bitboard checkers = calcAttackersTo(static_cast<Square>(kingSqr), occupancy) & opMaterial;
+
+    // sliders which would see the king on an empty board, pinning if exactly one of our pieces is in between.
+    const Bitboard orthogonal = (m_materialMask.rooks() | m_materialMask.queens()) & opMaterial;
+    const Bitboard diagonal = (m_materialMask.bishops() | m_materialMask.queens()) & opMaterial;
+    Bitboard snipers = (attacks::getRookAttacks(kingSqr, 0) & orthogonal) | (attacks::getBishopAttacks(kingSqr, 0) & diagonal);
+
+    Bitboard pinners = 0;
+    Bitboard pinned = 0;
+    while (snipers.empty() == false) {
+        const u8 sniperSqr = static_cast<u8>(snipers.popLsb());
+        const Bitboard between = Bitboard(ray::getRay(kingSqr, sniperSqr) & ~squareMaskTable[sniperSqr]) & occupancy;
+        if (between.count() == 1 && (between & opMaterial).empty()) {
+            pinners |= squareMaskTable[sniperSqr];
+            pinned |= between;
+        }
+    }
+
+    return { checkers, pinners, pinned };
+}
+
+template<Set us>
+CheckInfo
+Position::calcCheckInfo() const
+{
+    constexpr Set op = opposing_set<us>();
+    CheckInfo checkInfo;
+    const Bitboard opKing = m_materialMask.kings<op>();
+    if (opKing.empty())
+        return checkInfo;
+
+    const u8 kingSqr = static_cast<u8>(opKing.lsbIndex());
+    const u64 occupancy = m_materialMask.combine().read();
+    checkInfo.kingSqr = static_cast<Square>(kingSqr);
+
+    // a pawn of ours checks from the squares a pawn of theirs would attack from the king square.
+    checkInfo.checkSquares[pawnId] = attacks::getPawnAttacks(static_cast<u8>(op), kingSqr);
+    checkInfo.checkSquares[knightId] = attacks::getKnightAttacks(kingSqr);
+    checkInfo.checkSquares[bishopId] = attacks::getBishopAttacks(kingSqr, occupancy);
+    checkInfo.checkSquares[rookId] = attacks::getRookAttacks(kingSqr, occupancy);
+    checkInfo.checkSquares[queenId] = checkInfo.checkSquares[bishopId] | checkInfo.checkSquares[rookId];
+
+    const Bitboard usMaterial = m_materialMask.combine<us>();
+    const Bitboard orthogonal = m_materialMask.rooks<us>() | m_materialMask.queens<us>();
+    const Bitboard diagonal = m_materialMask.bishops<us>() | m_materialMask.queens<us>();
+    Bitboard snipers = (attacks::getRookAttacks(kingSqr, 0) & orthogonal) | (attacks::getBishopAttacks(kingSqr, 0) & diagonal);
+    while (snipers.empty() == false) {
+        const u8 sniperSqr = static_cast<u8>(snipers.popLsb());
+        const Bitboard between = Bitboard(ray::getRay(kingSqr, sniperSqr) & ~squareMaskTable[sniperSqr]) & occupancy;
+        if (between.count() == 1 && (between & usMaterial).empty() == false)
+            checkInfo.discoverers |= between;
+    }
+
+    return checkInfo;
+}
+
+template CheckInfo Position::calcCheckInfo<Set::WHITE>() const;
+template CheckInfo Position::calcCheckInfo<Set::BLACK>() const;
+
+template<Set us>
+bool
+Position::isPseudoLegal(PackedMove move) const
+{
+    if (move.isNull())
+        return false;
+
+    constexpr u8 usIndx = static_cast<u8>(us);
+    const u8 source = static_cast<u8>(move.source());
+    const u8 target = static_cast<u8>(move.target());
+    const ChessPiece piece = m_mailbox[source];
+    if (piece.isValid() == false || piece.getSet() != us)
+        return false;
+
+    // our own pieces and the opponent king are never captured.
+    const ChessPiece victim = m_mailbox[target];
+    if (victim.isValid() && (victim.getSet() == us || victim.getType() == PieceType::KING))
+        return false;
+
+    const Bitboard sourceMask = squareMaskTable[source];
+    const Bitboard targetMask = squareMaskTable[target];
+    const u64 occupancy = m_materialMask.combine().read();
+
+    if (piece.index() == pawnId) {
+        if (move.isEnPassant())
+            return m_enpassantState.readSquare() == static_cast<Square>(target) && (attacks::getPawnAttacks(usIndx, source) & targetMask.read());
+
+        const bool promotes = (pawn_constants::promotionRank[usIndx] & targetMask.read()) != 0;
+        if (move.isPromotion() != promotes || move.isCapture() != victim.isValid() || move.isCastling())
+            return false;
+
+        if (move.isCapture())
+            return (attacks::getPawnAttacks(usIndx, source) & targetMask.read()) != 0;
+
+        const Bitboard unoccupied(~occupancy);
+        Bitboard pushes = sourceMask.shiftNorthRelative<us>() & unoccupied;
+        pushes |= (pushes & pawn_constants::baseRank[usIndx]).shiftNorthRelative<us>() & unoccupied;
+        return (pushes & targetMask).empty() == false;
+    }
+
+    // the move maker trusts the flags, they have to agree with the board.
+    if (move.isPromotion() || move.isEnPassant() || move.isCapture() != victim.isValid())
+        return false;
+
+    if (move.isCastling()) {
+        if (piece.index() != kingId || move.isCapture())
+            return false;
+
+        const bool kingSide = move.flags() == KING_CASTLE;
+        const u8 rights = m_castlingState.read() >> (usIndx * 2);
+        const u8 rankOffset = usIndx * 56;
+        if ((rights & (kingSide ? 1 : 2)) == 0 || source != rankOffset + 4 || target != rankOffset + (kingSide ? 6 : 2))
+            return false;
+
+        // squares between king and rook have to be empty, b1 included for the long castle.
+        const u64 between = kingSide ? (squareMaskTable[rankOffset + 5] | squareMaskTable[rankOffset + 6])
+                                     : (squareMaskTable[rankOffset + 1] | squareMaskTable[rankOffset + 2] | squareMaskTable[rankOffset + 3]);
+        return (occupancy & between) == 0;
+    }
+
+    u64 attacked = 0;
+    switch (piece.index()) {
+        case knightId:
+            attacked = attacks::getKnightAttacks(source);
+            break;
+        case bishopId:
+            attacked = attacks::getBishopAttacks(source, occupancy);
+            break;
+        case rookId:
+            attacked = attacks::getRookAttacks(source, occupancy);
+            break;
+        case queenId:
+            attacked = attacks::getBishopAttacks(source, occupancy) | attacks::getRookAttacks(source, occupancy);
+            break;
+        default:
+            attacked = attacks::getKingAttacks(source);
+            break;
+    }
+    return (attacked & targetMask.read()) != 0;
+}
+
+template bool Position::isPseudoLegal<Set::WHITE>(PackedMove) const;
+template bool Position::isPseudoLegal<Set::BLACK>(PackedMove) const;
+
+template<Set us>
+bool
+Position::isLegal(PackedMove move) const
+{
+    const Bitboard king = m_materialMask.kings<us>();
+    if (king.empty())
+        return true;
+
+    const Bitboard opMaterial = m_materialMask.combine<opposing_set<us>()>();
+    const u8 source = static_cast<u8>(move.source());
+    const u8 target = static_cast<u8>(move.target());
+    const Bitboard sourceMask = squareMaskTable[source];
+    const Bitboard targetMask = squareMaskTable[target];
+    const Bitboard occupancy = m_materialMask.combine();
+
+    if (king & sourceMask) {
+        if (move.isCastling()) {
+            // can't castle out of, through or into check.
+            const i32 step = target > source ? 1 : -1;
+            for (i32 sqr = source; sqr != target + step; sqr += step) {
+                if (calcAttackersTo(static_cast<Square>(sqr), occupancy) & opMaterial)
+                    return false;
+            }
+            return true;
+        }
+
+        // the king itself is taken out so it can't hide behind the square it's leaving.
+        const Bitboard attackers = calcAttackersTo(static_cast<Square>(target), occupancy ^ sourceMask);
+        return (attackers & opMaterial & ~targetMask).empty();
+    }
+
+    // look at the attacks on our king with the board as it would be after the move, anything
+    // captured is no longer in the occupancy and so doesn't count as an attacker.
+    Bitboard captured = targetMask;
+    if (move.isEnPassant())
+        captured = squareMaskTable[static_cast<u8>(m_enpassantState.readTarget())];
+
+    const Bitboard after = ((occupancy ^ sourceMask) & ~captured) | targetMask;
+    const Bitboard attackers = calcAttackersTo(static_cast<Square>(king.lsbIndex()), after);
+    return (attackers & opMaterial & ~captured).empty();
+}
+
+template bool Position::isLegal<Set::WHITE>(PackedMove) const;
+template bool Position::isLegal<Set::BLACK>(PackedMove) const;
+
+bool
+Position::givesCheck(PackedMove move, const CheckInfo& checkInfo) const
+{
+    if (checkInfo.kingSqr == Square::NullSQ)
+        return false;
+
+    const u8 source = static_cast<u8>(move.source());
+    const u8 target = static_cast<u8>(move.target());
+    const u8 kingSqr = static_cast<u8>(checkInfo.kingSqr);
+    const Bitboard sourceMask = squareMaskTable[source];
+    const Bitboard targetMask = squareMaskTable[target];
+    const ChessPiece piece = m_mailbox[source];
+    const Set us = piece.getSet();
+
+    if (move.isPromotion()) {
+        // the promoted piece attacks from the target with the pawn gone from the source.
+        const u64 occupancy = (m_materialMask.combine() ^ sourceMask).read();
+        u64 attacked = 0;
+        switch (toPieceId(static_cast<PieceType>(move.readPromoteToPieceType()))) {
+            case knightId:
+                attacked = attacks::getKnightAttacks(target);
+                break;
+            case bishopId:
+                attacked = attacks::getBishopAttacks(target, occupancy);
+                break;
+            case rookId:
+                attacked = attacks::getRookAttacks(target, occupancy);
+                break;
+            default:
+                attacked = attacks::getBishopAttacks(target, occupancy) | attacks::getRookAttacks(target, occupancy);
+                break;
+        }
+        if (attacked & squareMaskTable[kingSqr])
+            return true;
+    }
+    else if (checkInfo.checkSquares[piece.index()] & targetMask) {
+        return true;
+    }
+
+    // discovered check, unless the piece stays on the line between the slider and the king.
+    if (checkInfo.discoverers & sourceMask) {
+        const bool staysOnLine = (ray::getRay(kingSqr, source) & targetMask.read()) || (ray::getRay(kingSqr, target) & sourceMask.read());
+        if (staysOnLine == false)
+            return true;
+    }
+
+    const Bitboard orthogonal = m_materialMask.read(us, rookId) | m_materialMask.read(us, queenId);
+    if (move.isEnPassant()) {
+        // the captured pawn leaving can uncover a slider as well.
+        const Bitboard captured = squareMaskTable[static_cast<u8>(m_enpassantState.readTarget())];
+        const u64 occupancy = ((m_materialMask.combine() ^ sourceMask ^ captured) | targetMask).read();
+        const Bitboard diagonal = m_materialMask.read(us, bishopId) | m_materialMask.read(us, queenId);
+        return (attacks::getRookAttacks(kingSqr, occupancy) & orthogonal.read()) || (attacks::getBishopAttacks(kingSqr, occupancy) & diagonal.read());
+    }
+
+    if (move.isCastling()) {
+        // the rook ends up next to the king on the square the king passed.
+        const bool kingSide = target > source;
+        const u8 rookSource = kingSide ? source + 3 : source - 4;
+        const u8 rookTarget = kingSide ? source + 1 : source - 1;
+        const Bitboard rookMove = squareMaskTable[rookSource] | squareMaskTable[rookTarget];
+        const u64 occupancy = (m_materialMask.combine() ^ sourceMask ^ rookMove ^ targetMask).read();
+        return (attacks::getRookAttacks(rookTarget, occupancy) & squareMaskTable[kingSqr]) != 0;
+    }
+
+    return false;
+}
+
+bool
+Position::isInsufficientMaterial() const
+{
+    if ((m_materialMask.pawns() | m_materialMask.rooks() | m_materialMask.queens()).empty() == false)
+        return false;
+
+    const Bitboard minors = m_materialMask.knights() | m_materialMask.bishops();
+    if (minors.count() <= 1)
+        return true;
+
+    // any number of bishops on the same colored squares can't force mate either.
+    if (m_materialMask.knights().empty() == false)
+        return false;
+
+    const Bitboard bishops = m_materialMask.bishops();
+    return (bishops & board_constants::lightSquares).empty() || (bishops & board_constants::darkSquares).empty();
+}
+
+CPU_DISPATCH i32
+Position::calcStaticExchangeEvaluation(Square source, Square target) const
+{
+    i32 gain[32]{};
+    u8 depth = 0;
+
+    ChessPiece attacker = readPieceAt(source);
+    ChessPiece victim = readPieceAt(target);
+    if (victim.isValid())
+        gain[0] = ChessPieceDef::Value(victim.index());
+    else if (attacker.getType() == PieceType::PAWN && m_enpassantState && m_enpassantState.readSquare() == target)
+        gain[0] = ChessPieceDef::Value(pawnId);
+
+    const Bitboard orthogonal = m_materialMask.rooks() | m_materialMask.queens();
+    const Bitboard diagonal = m_materialMask.bishops() | m_materialMask.queens();
+
+    Bitboard occupancy = m_materialMask.combine();
+    occupancy &= ~Bitboard(squareMaskTable[static_cast<u8>(source)]);
+    Bitboard attackers = calcAttackersTo(target, occupancy);
+
+    u8 attackerId = attacker.index();
+    u8 side = opposing_set(static_cast<u8>(attacker.getSet()));
+
+    while (depth < 31) {
+        depth++;
+        gain[depth] = ChessPieceDef::Value(attackerId) - gain[depth - 1];
+        // neither side can gain by continuing the exchange.
+        if (std::max(-gain[depth - 1], gain[depth]) < 0)
+            break;
+
+        const Bitboard sideAttackers = attackers & m_materialMask.combine(static_cast<Set>(side));
+        if (sideAttackers.empty())
+            break;
+
+        // find least valuable attacker of side to move.
+        Bitboard leastValuable;
+        for (attackerId = pawnId; attackerId <= kingId; ++attackerId) {
+            leastValuable = sideAttackers & m_materialMask.read(attackerId);
+            if (leastValuable.empty() == false)
+                break;
+        }
+
+        occupancy &= ~Bitboard(squareMaskTable[leastValuable.lsbIndex()]);
+
+        // remove the attacker and reveal any x-ray attackers behind it.
+        if (attackerId == pawnId || attackerId == bishopId || attackerId == queenId)
+            attackers |= attacks::getBishopAttacks(static_cast<u8>(target), occupancy.read()) & diagonal;
+        if (attackerId == rookId || attackerId == queenId)
+            attackers |= attacks::getRookAttacks(static_cast<u8>(target), occupancy.read()) & orthogonal;
+        attackers &= occupancy;
+
+        side ^= 1;
+    }
+
+    while (--depth)
+        gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+
+    return gain[0];
+}
+
+i32
+Position::calcStaticExchangeEvaluation(Square source, Square target, const AttackMaps& attackMaps) const
+{
+    const ChessPiece attacker = readPieceAt(source);
+    const Set op = static_cast<Set>(opposing_set(static_cast<u8>(attacker.getSet())));
+    if (attackMaps.isAttacked(op, target))
+        return calcStaticExchangeEvaluation(source, target);
+
+    // the maps are built with the piece still on source, an opponent slider behind it could
+    // recapture once it moves away.
+    const Bitboard sourceMask(squareMaskTable[static_cast<u8>(source)]);
+    Bitboard sliders = (m_materialMask.bishops() | m_materialMask.rooks() | m_materialMask.queens()) & m_materialMask.combine(op);
+    while (sliders.empty() == false) {
+        const u8 sliderSqr = static_cast<u8>(sliders.popLsb());
+        if ((attackMaps.bySquare(static_cast<Square>(sliderSqr)) & sourceMask).empty() == false
+            && (ray::getRay(sliderSqr, static_cast<u8>(target)) & sourceMask.read()) != 0)
+            return calcStaticExchangeEvaluation(source, target);
+    }
+
+    // nothing can recapture, we simply win whatever stands on target.
+    const ChessPiece victim = readPieceAt(target);
+    if (victim.isValid())
+        return ChessPieceDef::Value(victim.index());
+    if (attacker.getType() == PieceType::PAWN && m_enpassantState && m_enpassantState.readSquare() == target)
+        return ChessPieceDef::Value(pawnId);
+    return 0;
+}
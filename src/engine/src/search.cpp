@@ -7,7 +7,9 @@
 #include "fen_parser.h"
 #include "game_context.h"
 #include "move_generator.hpp"
+#include "time_manager.hpp"
 
+#include <algorithm>
 #include <future>
 #include <limits>
 #include <sstream>
@@ -24,9 +26,10 @@ Search::Perft(GameContext& context, int depth)
     }
 
     PerftResult result;
+    context.ReserveStates(depth);
     MoveGenerator generator(context);
     generator.generate();
-    generator.forEachMove([&](const PrioratizedMove& mv) {
+    for (const PrioratizedMove& mv : generator) {
         context.MakeMove(mv.move);
         result.Nodes++;
         if (mv.move.isCapture())
@@ -44,7 +47,7 @@ Search::Perft(GameContext& context, int depth)
 
         result += Perft(context, depth - 1);
         context.UnmakeMove();
-    });
+    }
 
     return result;
 }
@@ -57,9 +60,10 @@ Search::PerftDivide(GameContext& context, int depth)
     }
 
     PerftResult result;
+    context.ReserveStates(depth);
     MoveGenerator generator(context);
     generator.generate();
-    generator.forEachMove([&](const PrioratizedMove& mv) {
+    for (const PrioratizedMove& mv : generator) {
         context.MakeMove(mv.move);
         if (depth == 1) {
             result.Nodes++;
@@ -79,7 +83,7 @@ Search::PerftDivide(GameContext& context, int depth)
 
         result += PerftDivide(context, depth - 1);
         context.UnmakeMove();
-    });
+    }
 
     return result;
 }
@@ -88,63 +92,119 @@ u64 Search::Bench(GameContext& context, u32 depth) {
     return CalculateBestMove(context, { .SearchDepth = depth }).count;
 }
 
-void Search::ReportSearchResult(SearchContext& context, SearchResult& searchResult, u32 searchDepth, u32 itrDepth, u64 nodes, const Clock& clock) const {
+void Search::ReportSearchResult(SearchContext& context, SearchResult& searchResult, u32 searchDepth, u32 itrDepth, u64 nodes, const Clock& clock, u32 multiPV) const {
     i64 et = clock.getElapsedTime();
 
-    // build the principal variation string.
-    u32 madeMoves = 0;
-    std::stringstream pvSS;
-    for (u32 i = 0; i < searchDepth; ++i) {
-        u64 hash = context.game.readChessboard().readHash();
-        auto pvMove = context.game.editTranspositionTable().probe(hash);
-        if (pvMove.isNull())
-            break;
-        context.game.MakeMove(pvMove);
-        pvSS << " " << pvMove.toString();
-        madeMoves++;
-    }
+    for (u32 pvIndex = 0; pvIndex < multiPV; ++pvIndex) {
+        // the first line comes from the search result, others from the sorted root moves.
+        const PackedMove rootMove = pvIndex == 0 ? searchResult.move : m_rootMoves[pvIndex].move;
+        const i32 score = pvIndex == 0 ? searchResult.score : m_rootMoves[pvIndex].score;
+
+        // build the principal variation string.
+        u32 madeMoves = 0;
+        std::stringstream pvSS;
+        if (rootMove.isNull() == false) {
+            context.game.MakeMove(rootMove);
+            pvSS << " " << rootMove.toString();
+            madeMoves++;
+        }
+        for (u32 i = 1; i < searchDepth && madeMoves == i; ++i) {
+            u64 hash = context.game.readChessboard().readHash();
+            auto pvMove = context.game.editTranspositionTable().probe(hash);
+            if (pvMove.isNull())
+                break;
+            // a table shared with other searches can hand back a move of another position.
+            const Position& position = context.game.readChessboard().readPosition();
+            const bool legal = context.game.readToPlay() == Set::WHITE
+                ? position.isPseudoLegal<Set::WHITE>(pvMove) && position.isLegal<Set::WHITE>(pvMove)
+                : position.isPseudoLegal<Set::BLACK>(pvMove) && position.isLegal<Set::BLACK>(pvMove);
+            if (legal == false)
+                break;
+            context.game.MakeMove(pvMove);
+            pvSS << " " << pvMove.toString();
+            madeMoves++;
+        }
 
-    for (u32 i = 0; i < madeMoves; ++i) {
-        context.game.UnmakeMove();
-    }
+        for (u32 i = 0; i < madeMoves; ++i) {
+            context.game.UnmakeMove();
+        }
 
-    i32 checkmateDistance = c_checkmateConstant - abs((int)searchResult.score);
-    checkmateDistance = abs(checkmateDistance);
-    if ((u32)checkmateDistance <= searchDepth) {
-        // found checkmate within depth.
-        searchResult.ForcedMate = true;
-        checkmateDistance /= 2;
-        std::cout << "info mate " << checkmateDistance << " depth " << itrDepth << " nodes " << nodes
-            << " time " << et << " pv" << pvSS.str() << "\n";
+        std::cout << "info depth " << itrDepth << " multipv " << pvIndex + 1;
 
-        return;
+        i32 checkmateDistance = c_checkmateConstant - abs((int)score);
+        checkmateDistance = abs(checkmateDistance);
+        if ((u32)checkmateDistance <= searchDepth) {
+            // found checkmate within depth.
+            if (pvIndex == 0)
+                searchResult.ForcedMate = true;
+            checkmateDistance /= 2;
+            std::cout << " score mate " << (score > 0 ? checkmateDistance : -checkmateDistance);
+        }
+        else {
+            std::cout << " score cp " << score;
+        }
+
+        std::cout << " nodes " << nodes << " time " << et << " pv" << pvSS.str() << "\n";
     }
+}
 
-    i32 centipawn = searchResult.score;
-    std::cout << "info score cp " << centipawn << " depth " << itrDepth
-        << " nodes " << nodes << " time " << et << " pv" << pvSS.str() << "\n";
+void Search::BuildRootMoves(GameContext& context, const std::vector<PackedMove>& searchMoves)
+{
+    m_rootMoves.clear();
+    MoveGenerator generator(context, context.editTranspositionTable(), *this, 1);
+    for (auto prioratized = generator.generateNextMove(); prioratized.move.isNull() == false; prioratized = generator.generateNextMove()) {
+        if (searchMoves.empty() == false
+            && std::find(searchMoves.begin(), searchMoves.end(), prioratized.move) == searchMoves.end())
+            continue;
+
+        m_rootMoves.push_back({ .move = prioratized.move });
+    }
 }
 
-i32 Search::CalculateMove(GameContext& context, bool maximizingPlayer, u32 depth)
+i32 Search::CalculateMove(GameContext& context, u32 depth)
 {
     i32 alpha = -c_maxScore;
     i32 beta = c_maxScore;
     u32 ply = 1;
     u64 nodeCount = 0;
-    std::function<bool()> cancelleation = []() { return false; };
-    SearchContext searchContext = { context, nodeCount, cancelleation };
-    auto eval = AlphaBetaNegamax(searchContext, depth, alpha, beta, !maximizingPlayer, ply);
+    SearchContext searchContext = { context, nodeCount };
+    m_stop = false;
+    m_timeManager = nullptr;
+    m_nodeLimit = 0;
+    // the deepest line is the search depth followed by a full quiescence search.
+    context.ReserveStates(depth + c_maxQuiescenceDepth);
+
+    if (context.readToPlay() == Set::WHITE)
+        return AlphaBetaNegamax<Set::WHITE>(searchContext, depth, alpha, beta, ply).score;
 
-    return eval.score;
+    return AlphaBetaNegamax<Set::BLACK>(searchContext, depth, alpha, beta, ply).score;
 }
 
 SearchResult Search::CalculateBestMove(GameContext& context, SearchParameters params)
 {
-    Clock searchClock;
-    searchClock.Start();
+    TimeManager timeManager;
+    timeManager.begin(params, context.readToPlay());
     u64 nodeCount = 0;
-    std::function<bool()> cancellationFunc = buildCancellationFunction(context.readToPlay(), params, searchClock);
-    SearchContext searchContext = { context, nodeCount, cancellationFunc };
+    SearchContext searchContext = { context, nodeCount };
+    m_stop = false;
+    m_pollCountdown = c_stopPollInterval;
+    m_timeManager = &timeManager;
+    m_nodeLimit = params.NodeLimit;
+    m_nodesSearched = 0;
+    decayHistory();
+    // the board may have been set up without going through MakeMove.
+    context.RefreshState();
+    // frames can't move once the search holds on to them, make room for the deepest line up front.
+    context.ReserveStates(params.SearchDepth + c_maxQuiescenceDepth);
+
+    BuildRootMoves(context, params.SearchMoves);
+    if (m_rootMoves.empty()) {
+        // checkmate or stalemate, there is nothing to search.
+        MoveGenerator generator(context);
+        m_timeManager = nullptr;
+        return { .score = generator.isChecked() ? -c_checkmateConstant + 1 : -c_drawConstant, .move = PackedMove::NullMove() };
+    }
+    const u32 multiPV = std::clamp<u32>(params.MultiPV, 1, (u32)m_rootMoves.size());
 
     SearchResult result;
     for (u32 itrDepth = 1; itrDepth <= params.SearchDepth; ++itrDepth) {
@@ -152,15 +212,28 @@ SearchResult Search::CalculateBestMove(GameContext& context, SearchParameters pa
         Clock clock;
         clock.Start();
         nodeCount = 0;
-        auto itrResult = CalculateBestMoveIterration(searchContext, itrDepth);
+        SearchResult itrResult;
+        for (u32 pvIndex = 0; pvIndex < multiPV; ++pvIndex) {
+            auto lineResult = CalculateBestMoveIterration(searchContext, itrDepth, pvIndex);
+            if (pvIndex == 0)
+                itrResult = lineResult;
+            if (m_stop.load(std::memory_order_relaxed))
+                break;
+        }
         clock.Stop();
 
-        bool cancelled = cancellationFunc();
+        bool cancelled = m_stop.load(std::memory_order_relaxed);
         if (cancelled) {
-            itrResult = result;
+            // a partial first iteration is still better than no move at all.
+            if (result.move.isNull())
+                result = itrResult;
+            else
+                itrResult = result;
         }
+        m_nodesSearched += nodeCount;
 
-        ReportSearchResult(searchContext, itrResult, params.SearchDepth, itrDepth, nodeCount, clock);
+        // lines other than the first are incomplete in a cancelled iteration.
+        ReportSearchResult(searchContext, itrResult, params.SearchDepth, itrDepth, nodeCount, clock, cancelled ? 1 : multiPV);
         if (itrResult.ForcedMate) {
 #ifdef DEBUG_TRANSITION_TABLE
             context.editTranspositionTable().debugStatistics();
@@ -172,41 +245,121 @@ SearchResult Search::CalculateBestMove(GameContext& context, SearchParameters pa
             break;
 
         result = itrResult;
+
+        timeManager.update(result.move, result.score, m_rootMoves[0].nodes, nodeCount);
+        // with a single legal move there is nothing to think about.
+        if (timeManager.hasTimeLimit() && (m_rootMoves.size() == 1 || timeManager.softLimitReached()))
+            break;
     }
 
 #ifdef DEBUG_TRANSITION_TABLE
     context.editTranspositionTable().debugStatistics();
 #endif
 
+    m_timeManager = nullptr;
     result.count = nodeCount;
     return result;
 }
 
-SearchResult Search::CalculateBestMoveIterration(SearchContext& context, u32 depth) {
-    bool maximizingPlayer = context.game.readToPlay() == Set::WHITE;
+SearchResult Search::CalculateBestMoveIterration(SearchContext& context, u32 depth, u32 pvIndex) {
+    // only place we branch on side to move, from here on the search flips the template
+    // argument every ply.
+    if (context.game.readToPlay() == Set::WHITE)
+        return SearchRoot<Set::WHITE>(context, depth, pvIndex);
 
-    u32 ply = 1;
+    return SearchRoot<Set::BLACK>(context, depth, pvIndex);
+}
 
-    auto result = AlphaBetaNegamax(context, depth, -c_maxScore, c_maxScore, maximizingPlayer, ply);
+template<Set us>
+SearchResult Search::SearchRoot(SearchContext& context, u32 depth, u32 pvIndex) {
+    constexpr Set op = opposing_set<us>();
+    const u32 ply = 1;
+    i32 alpha = -c_maxScore;
+    const i32 beta = c_maxScore;
+    i32 bestEval = -c_maxScore;
+    PackedMove bestMove;
 
-    return result;
+    for (u32 i = pvIndex; i < m_rootMoves.size(); ++i) {
+        RootMove& rootMove = m_rootMoves[i];
+        const u64 nodesBeforeMove = context.nodes;
+        context.game.MakeMove(rootMove.move);
+
+        i32 eval = -c_drawConstant;
+        if (context.game.IsRepetition(context.game.readChessboard().readHash()) == false)
+            eval = -AlphaBetaNegamax<op>(context, depth - 1, -beta, -alpha, ply + 1).score;
+
+        context.game.UnmakeMove();
+        context.nodes++;
+
+        // hand back the best move found so far, the interrupted move has no reliable score.
+        if (isStopped(context))
+            return { .score = bestEval, .move = bestMove };
+
+        rootMove.score = eval;
+        rootMove.nodes = context.nodes - nodesBeforeMove;
+        if (eval > bestEval) {
+            bestEval = eval;
+            bestMove = rootMove.move;
+            if (eval > alpha)
+                alpha = eval;
+        }
+    }
+
+    // move the best move up front for the next line and the next iteration, the remaining moves
+    // only have upper bounds as scores so they keep their relative order.
+    auto best = std::find_if(m_rootMoves.begin() + pvIndex, m_rootMoves.end(),
+        [&](const RootMove& rootMove) { return rootMove.move == bestMove; });
+    if (best != m_rootMoves.end())
+        std::rotate(m_rootMoves.begin() + pvIndex, best, best + 1);
+
+    if (pvIndex == 0) {
+        auto& chessboard = context.game.readChessboard();
+        auto& entry = context.game.editTranspositionTable().editEntry(chessboard.readHash());
+        entry.update(chessboard.readHash(), bestMove, chessboard.readAge(), bestEval, ply, depth, TTF_CUT_EXACT);
+    }
+
+    return { .score = bestEval, .move = bestMove };
 }
 
-SearchResult Search::AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alpha, i32 beta, bool maximizingPlayer, u32 ply) {
-    if (context.cancel() == true || depth <= 0) {
+template SearchResult Search::SearchRoot<Set::WHITE>(SearchContext&, u32, u32);
+template SearchResult Search::SearchRoot<Set::BLACK>(SearchContext&, u32, u32);
+
+template<Set us>
+SearchResult Search::AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alpha, i32 beta, u32 ply) {
+    constexpr Set op = opposing_set<us>();
+    if (isStopped(context) || depth <= 0) {
         // at depth zero we start the quiet search to get a better evaluation.
         // this search will try to go as deep as possible until it finds a quiet position.
-        i32 score = QuiescenceNegamax(context, 4, alpha, beta, maximizingPlayer, 1);
+        i32 score = QuiescenceNegamax<us>(context, 0, alpha, beta, ply);
         return { .score = score, .move = PackedMove::NullMove() };
     }
 
+    if (ply > 1) {
+        // dead drawn positions, no reason to search any further.
+        if (context.game.IsFiftyMoveDraw() || context.game.readChessboard().readPosition().isInsufficientMaterial())
+            return { .score = c_drawConstant, .move = PackedMove::NullMove() };
+
+        // mate distance pruning, even mating on the next ply can't beat a shorter mate already found.
+        alpha = std::max(alpha, -c_checkmateConstant + (i32)ply);
+        beta = std::min(beta, c_checkmateConstant - (i32)ply - 1);
+        if (alpha >= beta)
+            return { .score = alpha, .move = PackedMove::NullMove() };
+    }
+
+    // if we can repeat an earlier position of the search tree we're guaranteed at least a draw.
+    if (ply > 1 && alpha < c_drawConstant && context.game.HasUpcomingRepetition(ply)) {
+        alpha = c_drawConstant;
+        if (alpha >= beta)
+            return { .score = alpha, .move = PackedMove::NullMove() };
+    }
+
     // initialize the move generator.
     MoveGenerator generator(context.game, context.game.editTranspositionTable(), *this, ply);
-    auto prioratized = generator.generateNextMove();
+    auto prioratized = generator.generateNextMove<us>();
 
     // if there are no moves to make, we're either in checkmate or stalemate.
     if (prioratized.move.isNull()) {
-        if (generator.isChecked())
+        if (generator.isChecked<us>())
             return { -c_checkmateConstant + (i32)ply, PackedMove::NullMove() };  // negative "infinity" since we're in checkmate
         return { .score = -c_drawConstant, .move = PackedMove::NullMove() };  // we're in stalemate
     }
@@ -237,7 +390,7 @@ SearchResult Search::AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alp
 #if defined(ENABLE_LATE_MOVE_REDUCTION)
         // should implement research on beta cutoffs.
         if (depth > 3 && depthReductionCounter >= depthReductionThreshold && extendedDepth == 0 && prioratized.move.isCapture() == false) {
-            result = AlphaBetaNegamax(context, extendedDepth - 1, -beta, -alpha, !maximizingPlayer, ply + 1);
+            result = AlphaBetaNegamax<op>(context, extendedDepth - 1, -beta, -alpha, ply + 1);
             doFullSearch = result.score > alpha;
         }
 
@@ -251,14 +404,14 @@ SearchResult Search::AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alp
             result = { .score = eval, .move = prioratized.move };
         }
         else if (doFullSearch) {
-            result = AlphaBetaNegamax(context, extendedDepth - 1, -beta, -alpha, !maximizingPlayer, ply + 1);
+            result = AlphaBetaNegamax<op>(context, extendedDepth - 1, -beta, -alpha, ply + 1);
             eval = -result.score;
         }
 
         context.game.UnmakeMove();
         context.nodes++;
 
-        if (context.cancel() == true)
+        if (isStopped(context))
             return { .score = 0, .move = PackedMove::NullMove() };
 
         if (eval > bestEval) {
@@ -275,12 +428,12 @@ SearchResult Search::AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alp
                 if (prioratized.move.isCapture() == false)
                     pushKillerMove(prioratized.move, ply);
 
-                putHistoryHeuristic(static_cast<u8>(chessboard.readToPlay()), prioratized.move.source(), prioratized.move.target(), depth);
+                putHistoryHeuristic(static_cast<u8>(us), prioratized.move.source(), prioratized.move.target(), depth);
                 return { .score = bestEval, .move = bestMove };
             }
         }
 
-        prioratized = generator.generateNextMove();
+        prioratized = generator.generateNextMove<us>();
     } while (prioratized.move.isNull() == false);
 
     entry.update(chessboard.readHash(), bestMove, chessboard.readAge(), bestEval, ply, depth, flag);
@@ -288,98 +441,122 @@ SearchResult Search::AlphaBetaNegamax(SearchContext& context, u32 depth, i32 alp
     return { .score = bestEval, .move = bestMove };
 }
 
-i32 Search::QuiescenceNegamax(SearchContext& context, u32 depth, i32 alpha, i32 beta, bool maximizingPlayer, u32 ply) {
-    MoveGenerator generator(context.game.readChessboard().readPosition(), context.game.readToPlay(), PieceType::NONE, MoveTypes::CAPTURES_ONLY);
-    generator.generate();
+template SearchResult Search::AlphaBetaNegamax<Set::WHITE>(SearchContext&, u32, i32, i32, u32);
+template SearchResult Search::AlphaBetaNegamax<Set::BLACK>(SearchContext&, u32, i32, i32, u32);
 
-    Evaluator evaluator;
-    i32 perspective = maximizingPlayer ? 1 : -1;
-    i32 eval = evaluator.Evaluate(context.game.readChessboard(), generator) * perspective;
-    if (eval >= beta)
-        return beta;
-    if (eval > alpha)
-        alpha = eval;
+template<Set us>
+i32 Search::QuiescenceNegamax(SearchContext& context, u32 qply, i32 alpha, i32 beta, u32 ply) {
+    constexpr Set op = opposing_set<us>();
+    const auto& chessboard = context.game.readChessboard();
+    const auto& position = chessboard.readPosition();
+    const u64 hash = chessboard.readHash();
 
-    auto prioratized = generator.generateNextMove();
+    if (isStopped(context))
+        return 0;
 
-    if (context.cancel() == true
-        || prioratized.move.isNull()
-        || ply >= c_maxSearchDepth
-        || (depth <= 0 && generator.isChecked() == false)) {
+    // captures often trade down into a dead drawn ending.
+    if (position.isInsufficientMaterial())
+        return c_drawConstant;
 
-        return eval;
+#if defined(ENABLE_TRANSPOSITION_TABLE)
+    // any entry is at least as deep as the quiescence search.
+    auto& entry = context.game.editTranspositionTable().editEntry(hash);
+    if (auto result = entry.evaluate(hash, 0, alpha, beta); result.has_value()) {
+        return entry.adjustedScore(ply);
     }
+#endif
 
-    i32 maxEval = -c_maxScore;
-    do {
-        context.game.MakeMove(prioratized.move);
-        i32 eval = -QuiescenceNegamax(context, depth - 1, -beta, -alpha, !maximizingPlayer, ply + 1);
-        context.nodes++;
-        context.game.UnmakeMove();
-
-        maxEval = std::max(maxEval, eval);
-        alpha = std::max(alpha, eval);
-
-        if (beta <= alpha)
-            return beta;
-
-        prioratized = generator.generateNextMove();
-    } while (prioratized.move.isNull() == false);
+    // when in check we can't stand pat, every evasion has to be searched.
+    const bool checked = context.game.readState().checkers.empty() == false;
 
-    return maxEval;
-}
+#if defined(ENABLE_QUIESCENCE_CHECKS)
+    const bool quietChecks = qply == 0 && checked == false;
+#else
+    const bool quietChecks = false;
+#endif
 
-bool Search::TimeManagement(i64 elapsedTime, i64 timeleft, i32 timeInc, u32 depth) {
-    // should return false if we want to abort our search.
-    // how do we manage time?
-    // lots of magic numbers in here.
-    const i64 c_maxTimeAllowed = (timeInc * .75f) + (timeleft / 32);  // at 5min this is 9 seconds.
-    if (elapsedTime > c_maxTimeAllowed) {
-        return false;
-    }
-    else {
-        i64 avrgTime = elapsedTime / depth;
-        avrgTime *= avrgTime;  // assume exponential time increase per depth.
-        avrgTime /= 2;         // give some credit to the alpha beta search.
-        if (avrgTime > c_maxTimeAllowed)
-            return false;
-        else
-            return true;
+    MoveTypes moveTypes = (checked || quietChecks) ? MoveTypes::ALL : MoveTypes::CAPTURES_ONLY;
+    MoveGenerator generator(context.game, moveTypes);
+
+    i32 standPat = -c_maxScore;
+    if (checked == false) {
+        Evaluator evaluator;
+        standPat = evaluator.Evaluate<us>(chessboard, generator);
+        if (standPat >= beta)
+            return standPat;
+        if (standPat > alpha)
+            alpha = standPat;
     }
 
-    return false;
-}
+    if (qply >= c_maxQuiescenceDepth)
+        return checked ? alpha : standPat;
+
+    const i32 alphaOriginal = alpha;
+    i32 bestEval = standPat;
+    PackedMove bestMove = PackedMove::NullMove();
+    bool hasMoves = false;
+
+    auto prioratized = generator.generateNextMove<us>();
+    while (prioratized.move.isNull() == false) {
+        const PackedMove move = prioratized.move;
+        const bool givesCheck = prioratized.isCheck();
+        prioratized = generator.generateNextMove<us>();
+        hasMoves = true;
+
+        // with quiet checks enabled the generator hands us every move, only keep the ones it
+        // flagged as giving check.
+        const bool quiet = move.isCapture() == false && move.isPromotion() == false;
+        if (checked == false && quiet && givesCheck == false)
+            continue;
+
+        if (checked == false && move.isCapture() && move.isPromotion() == false) {
+            // delta pruning, even winning the captured piece for free won't get us back to alpha.
+            const ChessPiece victim = position.readPieceAt(move.targetSqr());
+            const i32 victimValue = move.isEnPassant() ? ChessPieceDef::Value(pawnId) : ChessPieceDef::Value(victim.index());
+            if (standPat + victimValue + c_deltaPruningMargin <= alpha)
+                continue;
+
+            // skip moves which lose material in the exchange that follows.
+            if (position.calcStaticExchangeEvaluation(move.sourceSqr(), move.targetSqr(), generator.readAttackMaps()) < 0)
+                continue;
+        }
 
-CancelSearchCondition Search::buildCancellationFunction(Set perspective, const SearchParameters& params, const Clock& clock) const {
-    if (params.BlackTimelimit == 0 && params.WhiteTimelimit == 0 && params.MoveTime == 0) {
-        // we will never cancel a search based on time.
-        return [&]() {
-            return false;
-            };
-    }
+        context.game.MakeMove(move);
+        i32 eval = -QuiescenceNegamax<op>(context, qply + 1, -beta, -alpha, ply + 1);
+        context.nodes++;
+        context.game.UnmakeMove();
+
+        if (isStopped(context))
+            return 0;
 
-    if (params.MoveTime > 0) {
-        i64 moveTime = params.MoveTime;
-        return [&clock, moveTime]() {
-            return clock.getElapsedTime() > moveTime;
-            };
+        if (eval > bestEval) {
+            bestEval = eval;
+            bestMove = move;
+            if (eval > alpha)
+                alpha = eval;
+            if (beta <= alpha)
+                break;
+        }
     }
 
-    u32 timelimit = perspective == Set::WHITE ? params.WhiteTimelimit : params.BlackTimelimit;
-    i32 timeInc = perspective == Set::WHITE ? params.WhiteTimeIncrement : params.BlackTimeIncrement;
+    // no evasions available, we've been mated.
+    if (checked && hasMoves == false)
+        return -c_checkmateConstant + (i32)ply;
 
-    if (timelimit > 0) {
-        const i64 c_maxTimeAllowed = timeInc + (timelimit / 24);  // at 5min this is 12 seconds, at 1min this is 2.5 seconds
-        return [&clock, c_maxTimeAllowed]() {
-            return clock.getElapsedTime() > c_maxTimeAllowed;
-            };
+#if defined(ENABLE_TRANSPOSITION_TABLE)
+    // never replace results from the main search with quiescence results.
+    if (entry.hash != hash || entry.depth == 0) {
+        auto flag = bestEval >= beta ? TTF_CUT_BETA : bestEval > alphaOriginal ? TTF_CUT_EXACT : TTF_CUT_ALPHA;
+        entry.update(hash, bestMove, chessboard.readAge(), bestEval, ply, 0, flag);
     }
+#endif
 
-    return [&]() {
-        return true;
-        };
+    return bestEval;
 }
 
+template i32 Search::QuiescenceNegamax<Set::WHITE>(SearchContext&, u32, i32, i32, u32);
+template i32 Search::QuiescenceNegamax<Set::BLACK>(SearchContext&, u32, i32, i32, u32);
+
 i32 Search::Extension(const Chessboard&, const PrioratizedMove& prioratized, u32 ply) const {
     if (ply >= c_maxSearchDepth)
         return 0;
@@ -406,6 +583,21 @@ void Search::clear() {
     }
 }
 
+void Search::decayHistory() {
+    for (u32 i = 0; i < 2; ++i) {
+        for (u32 j = 0; j < 64; ++j) {
+            for (u32 k = 0; k < 64; ++k) {
+                m_historyHeuristic[i][j][k] /= 2;
+            }
+        }
+    }
+    for (u32 i = 0; i < 4; ++i) {
+        for (u32 j = 0; j < 64; ++j) {
+            m_killerMoves[i][j] = PackedMove::NullMove();
+        }
+    }
+}
+
 bool Search::isKillerMove(PackedMove move, u32 ply) const {
     const PackedMove* movesAtPly = &m_killerMoves[0][ply];
     return movesAtPly[0] == move || movesAtPly[1] == move || movesAtPly[2] == move || movesAtPly[3] == move;
@@ -0,0 +1,82 @@
+#include "time_manager.hpp"
+#include "search.hpp"
+
+#include <algorithm>
+
+void TimeManager::begin(const SearchParameters& params, Set perspective)
+{
+    using namespace time_manager_constants;
+    m_clock.Start();
+    m_softLimit = 0;
+    m_hardLimit = 0;
+    m_bestMove = PackedMove::NullMove();
+    m_stability = 0;
+    m_previousScore = 0;
+    m_hasPreviousScore = false;
+    m_scale = 1.f;
+    m_fixedTime = false;
+
+    if (params.Infinite)
+        return;
+
+    if (params.MoveTime > 0) {
+        m_fixedTime = true;
+        m_softLimit = std::max<i64>(1, (i64)params.MoveTime - moveOverhead);
+        m_hardLimit = m_softLimit;
+        return;
+    }
+
+    const i64 timeleft = perspective == Set::WHITE ? params.WhiteTimelimit : params.BlackTimelimit;
+    const i64 increment = perspective == Set::WHITE ? params.WhiteTimeIncrement : params.BlackTimeIncrement;
+    if (timeleft <= 0)
+        return;
+
+    const i64 movesToGo = params.MovesToGo > 0 ? std::min<i64>(params.MovesToGo, maxMovesToGo) : defaultMovesToGo;
+    // never plan on using more than what's left on the clock minus the overhead.
+    const i64 available = std::max<i64>(1, timeleft - moveOverhead);
+
+    m_softLimit = std::min(available, timeleft / movesToGo + (increment * 3) / 4);
+    // with a single move to go before the time control we can spend most of our time.
+    const i64 hardCap = movesToGo == 1 ? available : (available * 4) / 5;
+    m_hardLimit = std::max<i64>(1, std::min(hardCap, m_softLimit * hardLimitFactor));
+    m_softLimit = std::max<i64>(1, std::min(m_softLimit, m_hardLimit));
+}
+
+void TimeManager::update(PackedMove bestMove, i32 score, u64 bestMoveNodes, u64 totalNodes)
+{
+    if (m_fixedTime)
+        return;
+
+    // the longer the best move has stayed the same the less reason to keep searching.
+    if (bestMove == m_bestMove)
+        m_stability = std::min<u32>(m_stability + 1, 8);
+    else
+        m_stability = 0;
+    m_bestMove = bestMove;
+    const float stabilityFactor = 1.5f - 0.1f * (float)m_stability;
+
+    // spend more time when the score is dropping, something bad might be going on.
+    float scoreFactor = 1.f;
+    if (m_hasPreviousScore && score < m_previousScore) {
+        const i32 drop = std::min(m_previousScore - score, 200);
+        scoreFactor += 0.5f * (float)drop / 200.f;
+    }
+    m_previousScore = score;
+    m_hasPreviousScore = true;
+
+    // if most nodes went into the best move the alternatives are easily refuted.
+    float nodesFactor = 1.f;
+    if (totalNodes > 0) {
+        const float fraction = (float)bestMoveNodes / (float)totalNodes;
+        nodesFactor = (1.5f - fraction) * 1.25f;
+    }
+
+    m_scale = std::clamp(stabilityFactor * scoreFactor * nodesFactor, 0.3f, 3.f);
+}
+
+i64 TimeManager::readSoftLimit() const
+{
+    if (m_fixedTime)
+        return m_softLimit;
+    return std::min(m_hardLimit, std::max<i64>(1, (i64)((float)m_softLimit * m_scale)));
+}
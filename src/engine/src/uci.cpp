@@ -1,11 +1,16 @@
 #include "uci.hpp"
 
+#include "cpu.hpp"
 #include "elephant_gambit_config.h"
 #include "fen_parser.h"
 #include "game_context.h"
+#include "mate_search.hpp"
+#include "move_generator.hpp"
+#include "numa.hpp"
 #include "move.h"
 #include "search.hpp"
 
+#include <algorithm>
 #include <functional>
 #include <map>
 #include <optional>
@@ -17,6 +22,7 @@ UCI::UCI() :
 {
     m_stream << "id name Elephant Gambit " << ELEPHANT_GAMBIT_VERSION_STR << "\n";
     m_stream << "id author Alexander Loodin Ek\n";
+    m_stream << "info string cpu " << cpu::describe() << "\n";
     InitializeOptions();
 }
 
@@ -25,7 +31,24 @@ UCI::~UCI() { m_stream << "quit\n"; }
 void UCI::InitializeOptions() 
 {
     SetOption({"name", "Threads", "value", "1"});
+    SetOption({ "name", "NumaPlacement", "value", "FirstTouch" });
     SetOption({ "name", "Hash", "value", "8" });
+    SetOption({ "name", "MultiPV", "value", "1" });
+}
+
+void UCI::ApplyTranspositionTablePlacement()
+{
+    // the table is touched by one bound thread per search thread so it's spread like the search.
+    auto threads = m_options.find("Threads");
+    auto placement = m_options.find("NumaPlacement");
+    auto hash = m_options.find("Hash");
+    if (threads == m_options.end() || placement == m_options.end() || hash == m_options.end())
+        return;
+
+    auto& table = m_context.editTranspositionTable();
+    table.setPlacement(std::stoi(threads->second),
+        placement->second == "Interleave" ? numa::Placement::Interleave : numa::Placement::FirstTouch);
+    table.resize(std::stoi(hash->second));
 }
 
 void
@@ -69,10 +92,23 @@ UCI::SetOption(const std::list<std::string>& args)
 
     if (name->compare("Threads") == 0) {
         LOG_DEBUG() << "Threads: " << *value;
+        m_options["Threads"] = *value;
+        ApplyTranspositionTablePlacement();
+    }
+    else if (name->compare("NumaPlacement") == 0) {
+        if (*value != "FirstTouch" && *value != "Interleave") {
+            LOG_ERROR() << "Unknown NumaPlacement: " << *value;
+            return false;
+        }
+        m_options["NumaPlacement"] = *value;
+        ApplyTranspositionTablePlacement();
     }
     else if (name->compare("Hash") == 0) {
         m_options["Hash"] = *value;
-        m_context.editTranspositionTable().resize(std::stoi(*value));
+        ApplyTranspositionTablePlacement();
+    }
+    else if (name->compare("MultiPV") == 0) {
+        m_options["MultiPV"] = *value;
     }
     else {
         LOG_ERROR() << "Unknown option: " << *name;
@@ -142,6 +178,7 @@ UCI::Position(std::list<std::string>& args)
                 }
             }
 
+            m_context.ReserveStates(1);
             if (!m_context.MakeMove(move.readPackedMove())) {
                 LOG_ERROR() << "Failed to make move: " << move.toString();
                 return false;
@@ -182,6 +219,7 @@ bool
 UCI::NewGame()
 {
     m_context.NewGame();
+    m_context.ClearSearch();
     return true;
 }
 
@@ -200,9 +238,36 @@ UCI::Go(std::list<std::string>& args)
     // over the options, some times we need to jump twice. Hence the lambda
     // returns a optional, since the lambda can also fail.
     std::map<std::string, std::function<std::optional<int>(void)>> options;
-    options["searchmoves"] = []() {
-        LOG_ERROR() << "Not yet implemented";
-        return std::nullopt;
+    options["searchmoves"] = [&searchParams, &options, args, this]() -> std::optional<int> {
+        auto itr = std::find(args.begin(), args.end(), "searchmoves");
+        itr++;  // increment itr should hold the first move
+
+        MoveGenerator generator(m_context);
+        generator.generate();
+        int count = 0;
+        // moves run until the next option or the end of the command.
+        for (; itr != args.end() && options.find(*itr) == options.end(); ++itr) {
+            PackedMove found = PackedMove::NullMove();
+            for (const PrioratizedMove& pm : generator) {
+                if (pm.move.toString() == *itr) {
+                    found = pm.move;
+                    break;
+                }
+            }
+
+            if (found.isNull()) {
+                LOG_ERROR() << "Illegal searchmove: " << *itr;
+                return std::nullopt;
+            }
+            searchParams.SearchMoves.push_back(found);
+            count++;
+        }
+
+        if (count == 0) {
+            LOG_ERROR() << "No searchmoves specified";
+            return std::nullopt;
+        }
+        return count;
         };
     options["ponder"] = []() {
         LOG_ERROR() << "Not yet implemented";
@@ -263,13 +328,27 @@ UCI::Go(std::list<std::string>& args)
         LOG_DEBUG() << "movestogo " << searchParams.MovesToGo << "\n";
         return 1;
         };
-    options["nodes"] = []() {
-        LOG_ERROR() << "Not yet implemented";
-        return std::nullopt;
+    options["nodes"] = [&searchParams, args]() -> std::optional<int> {
+        auto itr = std::find(args.begin(), args.end(), "nodes");
+        itr++;  // increment itr should hold the value of "nodes"
+        if (itr == args.end()) {
+            LOG_ERROR() << "No nodes specified";
+            return std::nullopt;
+        }
+        searchParams.NodeLimit = std::stoull(*itr);
+        LOG_DEBUG() << "nodes " << searchParams.NodeLimit << "\n";
+        return 1;
         };
-    options["mate"] = []() {
-        LOG_ERROR() << "Not yet implemented";
-        return std::nullopt;
+    options["mate"] = [&searchParams, args]() -> std::optional<int> {
+        auto itr = std::find(args.begin(), args.end(), "mate");
+        itr++;  // increment itr should hold the value of "mate"
+        if (itr == args.end()) {
+            LOG_ERROR() << "No mate specified";
+            return std::nullopt;
+        }
+        searchParams.MateIn = std::stoi(*itr);
+        LOG_DEBUG() << "mate " << searchParams.MateIn << "\n";
+        return 1;
         };
     options["movetime"] = [&searchParams, args]() -> std::optional<int> {
         auto itr = std::find(args.begin(), args.end(), "movetime");
@@ -320,6 +399,25 @@ UCI::Go(std::list<std::string>& args)
         }
     }
 
+    if (auto multiPV = m_options.find("MultiPV"); multiPV != m_options.end())
+        searchParams.MultiPV = std::stoi(multiPV->second);
+
+    if (searchParams.MateIn > 0) {
+        Clock clock;
+        clock.Start();
+        MateSearch solver;
+        MateSearchResult mate = solver.Solve(m_context, searchParams);
+        if (mate.mateIn > 0) {
+            m_stream << "info depth " << mate.mateIn * 2 - 1 << " nodes " << mate.nodes << " time " << clock.getElapsedTime()
+                << " score mate " << mate.mateIn << " pv " << mate.move.toString() << "\n";
+            m_stream << "bestmove " << mate.move.toString();
+            m_stream << "\n";
+            return true;
+        }
+        // the solver only tries checking moves, give the regular search a chance at quiet mates.
+        searchParams.SearchDepth = std::min(searchParams.SearchDepth, searchParams.MateIn * 2);
+    }
+
     SearchResult result = m_context.CalculateBestMove(searchParams);
     m_stream << "bestmove " << result.move.toString();
     m_stream << "\n";
@@ -24,17 +24,22 @@ ${SRC_DIR}/elephant_test.cpp
 # Test files
 ${SRC_DIR}/bitboard_test.cpp
 ${SRC_DIR}/checkmate_test.cpp
+${SRC_DIR}/cpu_test.cpp
 ${SRC_DIR}/chessboard_test.cpp
 ${SRC_DIR}/fen_parser_test.cpp
 ${SRC_DIR}/game_context_test.cpp
+${SRC_DIR}/mate_search_test.cpp
 ${SRC_DIR}/move_test.cpp
 ${SRC_DIR}/move_generator_test.cpp
+${SRC_DIR}/move_list_test.cpp
+${SRC_DIR}/numa_test.cpp
 ${SRC_DIR}/perft_test.cpp
 ${SRC_DIR}/piece_test.cpp
 ${SRC_DIR}/position_test.cpp
 ${SRC_DIR}/rays_test.cpp
 ${SRC_DIR}/search_test.cpp
 ${SRC_DIR}/search_cases.hpp
+${SRC_DIR}/time_manager_test.cpp
 ${SRC_DIR}/transposition_test.cpp
 ${SRC_DIR}/unmake_test.cpp
 ${SRC_DIR}/uci_test.cpp
@@ -0,0 +1,29 @@
+#include <gtest/gtest.h>
+#include "cpu.hpp"
+
+namespace ElephantTest {
+
+TEST(CpuTest, BestLevel_RequiresEveryFeatureOfTheLevel) {
+    cpu::Features features;
+    EXPECT_EQ(cpu::Level::Baseline, cpu::bestLevel(features));
+
+    features.popcnt = true;
+    EXPECT_EQ(cpu::Level::Popcnt, cpu::bestLevel(features));
+
+    // avx2 without bmi2 isn't enough for the v3 path.
+    features.avx2 = true;
+    EXPECT_EQ(cpu::Level::Popcnt, cpu::bestLevel(features));
+
+    features.bmi2 = true;
+    EXPECT_EQ(cpu::Level::Avx2, cpu::bestLevel(features));
+}
+
+TEST(CpuTest, ActiveLevel_SupportedByRunningCpu) {
+    // the chosen path never uses instructions the cpu lacks.
+    EXPECT_LE(static_cast<u8>(cpu::activeLevel()), static_cast<u8>(cpu::bestLevel(cpu::detect())));
+
+    const std::string description = cpu::describe();
+    EXPECT_NE(std::string::npos, description.find(cpu::toString(cpu::activeLevel()))) << description;
+}
+
+}  // namespace ElephantTest
@@ -3,6 +3,8 @@
 #include "move.h"
 #include "elephant_test_utils.h"
 #include "hash_zorbist.h"
+#include "fen_parser.h"
+#include "search.hpp"
 
 
 namespace ElephantTest
@@ -115,4 +117,222 @@ void BuildPositionAfterMove18(Chessboard& board)
 //     EXPECT_EQ(board.readHash(), hashTwo);
 //     EXPECT_EQ(m_context.readChessboard().readHash(), board.readHash());
 // }
-}
\ No newline at end of file
+
+TEST_F(GameContextFixture, Repetition_KnightsShuffleTwice_ThirdOccurrenceIsRepetition)
+{
+    FENParser::deserialize(c_startPositionFen.c_str(), m_context);
+    const u64 startHash = m_context.readChessboard().readHash();
+    const PackedMove shuffle[4] = { PackedMove(g1.toSquare(), f3.toSquare()), PackedMove(g8.toSquare(), f6.toSquare()), PackedMove(f3.toSquare(), g1.toSquare()), PackedMove(f6.toSquare(), g8.toSquare()) };
+
+    for (const auto& mv : shuffle)
+        m_context.MakeMove(mv);
+
+    EXPECT_EQ(startHash, m_context.readChessboard().readHash());
+    EXPECT_FALSE(m_context.IsRepetition(startHash));
+
+    for (const auto& mv : shuffle)
+        m_context.MakeMove(mv);
+
+    EXPECT_TRUE(m_context.IsRepetition(startHash));
+
+    // a pawn move resets the halfmove clock, nothing before it can repeat.
+    m_context.MakeMove(PackedMove(e2.toSquare(), e4.toSquare()));
+    m_context.MakeMove(PackedMove(e7.toSquare(), e5.toSquare()));
+    for (const auto& mv : shuffle)
+        m_context.MakeMove(mv);
+    EXPECT_FALSE(m_context.IsRepetition(m_context.readChessboard().readHash()));
+}
+
+TEST_F(GameContextFixture, Repetition_KnightCanMoveBack_UpcomingRepetitionWithinSearchPly)
+{
+    FENParser::deserialize(c_startPositionFen.c_str(), m_context);
+    m_context.MakeMove(PackedMove(g1.toSquare(), f3.toSquare()));
+    m_context.MakeMove(PackedMove(g8.toSquare(), f6.toSquare()));
+    m_context.MakeMove(PackedMove(f3.toSquare(), g1.toSquare()));
+
+    // black can play Nf6-g8 and repeat the starting position, which is three plies back. It's
+    // inside the tree when the root is the position before it.
+    EXPECT_TRUE(m_context.HasUpcomingRepetition(5));
+    EXPECT_FALSE(m_context.HasUpcomingRepetition(3));
+
+    // pawn moves are irreversible, the earlier positions can't be reached again.
+    m_context.MakeMove(PackedMove(g7.toSquare(), g6.toSquare()));
+    m_context.MakeMove(PackedMove(g1.toSquare(), f3.toSquare()));
+    EXPECT_FALSE(m_context.HasUpcomingRepetition(64));
+}
+
+TEST_F(GameContextFixture, Repetition_CycleEndingAtTheRoot_IsNotUpcomingRepetition)
+{
+    // the search root is the starting position, searchPly 4 is three plies below it.
+    FENParser::deserialize(c_startPositionFen.c_str(), m_context);
+    m_context.MakeMove(PackedMove(g1.toSquare(), f3.toSquare()));
+    m_context.MakeMove(PackedMove(g8.toSquare(), f6.toSquare()));
+    m_context.MakeMove(PackedMove(f3.toSquare(), g1.toSquare()));
+
+    // Nf6-g8 would only bring back the root.
+    EXPECT_FALSE(m_context.HasUpcomingRepetition(4));
+    // with the root one ply earlier the repeated position is inside the tree.
+    EXPECT_TRUE(m_context.HasUpcomingRepetition(5));
+}
+
+TEST_F(GameContextFixture, GameOver_CheckmateStalemateAndDraws_AreDetected)
+{
+    FENParser::deserialize(c_startPositionFen.c_str(), m_context);
+    EXPECT_FALSE(m_context.GameOver());
+
+    // fool's mate
+    FENParser::deserialize("rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3", m_context);
+    EXPECT_TRUE(m_context.GameOver());
+
+    // stalemate
+    FENParser::deserialize("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", m_context);
+    EXPECT_TRUE(m_context.GameOver());
+
+    FENParser::deserialize("7k/8/6K1/8/8/8/2R5/8 b - - 100 80", m_context);
+    EXPECT_TRUE(m_context.IsFiftyMoveRule());
+    EXPECT_TRUE(m_context.GameOver());
+
+    FENParser::deserialize("7k/8/6K1/8/8/8/2B5/8 b - - 0 1", m_context);
+    EXPECT_TRUE(m_context.isGameOver());
+}
+
+TEST_F(GameContextFixture, FiftyMoveDraw_MateOnTheLastMoveStands)
+{
+    FENParser::deserialize("7k/8/6K1/8/8/8/2R5/8 b - - 100 80", m_context);
+    EXPECT_TRUE(m_context.IsFiftyMoveDraw());
+
+    // in check with a way out, still a draw.
+    FENParser::deserialize("7k/8/8/6K1/8/8/8/R7 w - - 99 80", m_context);
+    m_context.MakeMove(PackedMove(a1.toSquare(), a8.toSquare()));
+    EXPECT_TRUE(m_context.IsFiftyMoveRule());
+    EXPECT_TRUE(m_context.IsFiftyMoveDraw());
+
+    // Ra8 is mate and the hundredth half move.
+    FENParser::deserialize("7k/8/6K1/8/8/8/8/R7 w - - 99 80", m_context);
+    m_context.MakeMove(PackedMove(a1.toSquare(), a8.toSquare()));
+    EXPECT_TRUE(m_context.IsFiftyMoveRule());
+    EXPECT_FALSE(m_context.IsFiftyMoveDraw());
+    EXPECT_TRUE(m_context.GameOver());
+
+    // the search scores the mate instead of the draw. A fixed depth reaches the node after the
+    // mate with depth left, where the clock is tested, iterative deepening would stop at depth one.
+    FENParser::deserialize("7k/8/6K1/8/8/8/8/R7 w - - 99 80", m_context);
+    m_context.RefreshState();
+    Search search;
+    EXPECT_GT(search.CalculateMove(m_context, 3), c_checkmateConstant - 10);
+}
+
+static u64 sumHistory(const Search& search)
+{
+    u64 sum = 0;
+    for (u8 set = 0; set < 2; ++set)
+        for (u8 src = 0; src < 64; ++src)
+            for (u8 dst = 0; dst < 64; ++dst)
+                sum += search.getHistoryHeuristic(set, src, dst);
+    return sum;
+}
+
+TEST_F(GameContextFixture, CalculateBestMove_HistoryPersistsUntilClearSearch)
+{
+    m_context.NewGame();
+    EXPECT_EQ(0, sumHistory(m_context.readSearch()));
+
+    SearchParameters params;
+    params.SearchDepth = 4;
+    SearchResult result = m_context.CalculateBestMove(params);
+    const u64 firstHistory = sumHistory(m_context.readSearch());
+    EXPECT_GT(firstHistory, 0);
+
+    // next move of the game starts from the decayed history rather than from scratch.
+    m_context.MakeMove(result.move);
+    m_context.CalculateBestMove(params);
+    EXPECT_GT(sumHistory(m_context.readSearch()), firstHistory / 2);
+
+    // setting up a position keeps the search state, only a new game clears it.
+    m_context.NewGame();
+    EXPECT_GT(sumHistory(m_context.readSearch()), 0);
+    m_context.ClearSearch();
+    EXPECT_EQ(0, sumHistory(m_context.readSearch()));
+}
+
+TEST_F(GameContextFixture, TranspositionTable_SharedBetweenContexts)
+{
+    TranspositionTable table;
+    table.resize(1);
+    GameContext other;
+    m_context.shareTranspositionTable(table);
+    other.shareTranspositionTable(table);
+    EXPECT_EQ(&table, &m_context.editTranspositionTable());
+    EXPECT_EQ(&table, &other.editTranspositionTable());
+
+    // what one context searched is found by the other.
+    FENParser::deserialize("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", m_context);
+    FENParser::deserialize("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", other);
+    SearchParameters params;
+    params.SearchDepth = 3;
+    m_context.CalculateBestMove(params);
+    EXPECT_FALSE(other.editTranspositionTable().probe(other.readChessboard().readHash()).isNull());
+}
+
+TEST_F(GameContextFixture, StateStack_CheckersComputedInMakeAndRestoredOnUnmake)
+{
+    m_context.NewGame();
+    m_context.MakeMove(PackedMove(Square::E2, Square::E4));
+    m_context.MakeMove(PackedMove(Square::F7, Square::F6));
+    const u64 hash = m_context.readChessboard().readHash();
+    EXPECT_TRUE(m_context.readState().checkers.empty());
+
+    m_context.MakeMove(PackedMove(Square::D1, Square::H5));
+    EXPECT_EQ(squareMaskTable[static_cast<u8>(Square::H5)], m_context.readState().checkers.read());
+
+    // g6 blocks the check and is pinned by the queen.
+    m_context.MakeMove(PackedMove(Square::G7, Square::G6));
+    m_context.MakeMove(PackedMove(Square::A2, Square::A3));
+    EXPECT_TRUE(m_context.readState().checkers.empty());
+    EXPECT_EQ(squareMaskTable[static_cast<u8>(Square::H5)], m_context.readState().pinners.read());
+    EXPECT_EQ(squareMaskTable[static_cast<u8>(Square::G6)], m_context.readState().pinned.read());
+
+    m_context.UnmakeMove();
+    m_context.UnmakeMove();
+    EXPECT_EQ(squareMaskTable[static_cast<u8>(Square::H5)], m_context.readState().checkers.read());
+    m_context.UnmakeMove();
+    EXPECT_TRUE(m_context.readState().checkers.empty());
+    EXPECT_EQ(hash, m_context.readChessboard().readHash());
+}
+
+TEST_F(GameContextFixture, StateStack_PinnedPieceAndPinner)
+{
+    // the rook on e1 pins the knight on e4 to the black king.
+    FENParser::deserialize("4k3/8/8/8/4n3/8/8/K3R3 w - - 0 1", m_context);
+    m_context.MakeMove(PackedMove(Square::A1, Square::B1));
+    const StateInfo& state = m_context.readState();
+    EXPECT_TRUE(state.checkers.empty());
+    EXPECT_EQ(squareMaskTable[static_cast<u8>(Square::E1)], state.pinners.read());
+    EXPECT_EQ(squareMaskTable[static_cast<u8>(Square::E4)], state.pinned.read());
+}
+
+TEST_F(GameContextFixture, StateStack_GrowsPastPreallocatedFrames)
+{
+    m_context.NewGame();
+    const u64 hash = m_context.readChessboard().readHash();
+    const PackedMove shuffle[] = { PackedMove(Square::G1, Square::F3), PackedMove(Square::G8, Square::F6),
+        PackedMove(Square::F3, Square::G1), PackedMove(Square::F6, Square::G8) };
+
+    const u32 plies = c_stateStackSize + 100;
+    for (u32 i = 0; i < plies; ++i) {
+        m_context.ReserveStates(1);
+        m_context.MakeMove(shuffle[i % 4]);
+    }
+
+    // the search reserves its deepest line before it starts, at the end of a long game as well.
+    SearchParameters params;
+    params.SearchDepth = 3;
+    EXPECT_FALSE(m_context.CalculateBestMove(params).move.isNull());
+
+    for (u32 i = 0; i < plies; ++i)
+        EXPECT_TRUE(m_context.UnmakeMove());
+
+    EXPECT_FALSE(m_context.UnmakeMove());
+    EXPECT_EQ(hash, m_context.readChessboard().readHash());
+}
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "elephant_test_utils.h"
+
+#include "fen_parser.h"
+#include "game_context.h"
+#include "mate_search.hpp"
+#include "search.hpp"
+#include "search_cases.hpp"
+
+namespace ElephantTest {
+////////////////////////////////////////////////////////////////
+class MateSearchFixture : public ::testing::Test {
+public:
+    virtual void SetUp() {};
+    virtual void TearDown() {};
+
+    MateSearchResult solve(const std::string& fen, u32 mateIn, u64 nodeLimit = 0)
+    {
+        GameContext context;
+        FENParser::deserialize(fen.c_str(), context);
+        const u64 hash = context.readChessboard().readHash();
+
+        SearchParameters params;
+        params.MateIn = mateIn;
+        params.NodeLimit = nodeLimit;
+        MateSearch solver(1);
+        MateSearchResult result = solver.Solve(context, params);
+
+        // the solver has to leave the position untouched.
+        EXPECT_EQ(hash, context.readChessboard().readHash());
+        return result;
+    }
+};
+////////////////////////////////////////////////////////////////
+
+TEST_F(MateSearchFixture, BackRankMate_MateInOne)
+{
+    MateSearchResult result = solve("6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", 3);
+    EXPECT_EQ(1, result.mateIn);
+    EXPECT_EQ("a1a8", result.move.toString());
+}
+
+TEST_F(MateSearchFixture, BackRankMate_BlackMateInOne)
+{
+    MateSearchResult result = solve("r5k1/5ppp/8/8/8/8/5PPP/6K1 b - - 0 1", 3);
+    EXPECT_EQ(1, result.mateIn);
+    EXPECT_EQ("a8a1", result.move.toString());
+}
+
+TEST_F(MateSearchFixture, MateInFive_FindsCheckingMates)
+{
+    // the second case of the suite needs quiet moves by the attacker and is left to the regular search.
+    for (const auto& searchCase : { s_mateInFive[0], s_mateInFive[2] }) {
+        MateSearchResult result = solve(searchCase.fen, 5);
+        EXPECT_GT(result.mateIn, 0u) << searchCase.fen;
+        EXPECT_LE(result.mateIn, 5u) << searchCase.fen;
+        EXPECT_EQ(searchCase.expectedMove, result.move.toString()) << searchCase.fen;
+    }
+}
+
+TEST_F(MateSearchFixture, QuietMove_NotConsidered)
+{
+    // Re1 doesn't give check, the mate only follows after the quiet threat of Qg2.
+    MateSearchResult result = solve(s_mateInThree[0].fen, 3);
+    EXPECT_EQ(0, result.mateIn);
+    EXPECT_TRUE(result.move.isNull());
+}
+
+TEST_F(MateSearchFixture, StartPosition_NoMate)
+{
+    MateSearchResult result = solve(c_startPositionFen, 2);
+    EXPECT_EQ(0, result.mateIn);
+    EXPECT_TRUE(result.move.isNull());
+}
+
+TEST_F(MateSearchFixture, NodeLimit_StopsSearch)
+{
+    const auto& searchCase = s_mateInFive[0];
+    MateSearchResult result = solve(searchCase.fen, 5, 100);
+    EXPECT_EQ(0, result.mateIn);
+    EXPECT_LE(result.nodes, 100u);
+}
+
+}  // namespace ElephantTest
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 
 #include "elephant_test_utils.h"
 #include "fen_parser.h"
@@ -1958,4 +1959,161 @@ TEST_F(MoveGeneratorFixture, PerftTestPositionTwo_CaptureMoves_ShouldHaveEightCa
     EXPECT_EQ(8, result.size());
 }
 
-}  // namespace ElephantTest
\ No newline at end of file
+TEST_F(MoveGeneratorFixture, PerftTestPositionTwo_AfterNxf7_CaptureMovesFromStateMatchPosition)
+{
+    // setup
+    char inputFen[] = "r3k2r/p1ppqNb1/bn2pnp1/3P4/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1";
+    FENParser::deserialize(inputFen, testContext);
+
+    // do, checkers and pins of the black side come from the state of the ply.
+    MoveGenerator fromState(testContext, MoveTypes::CAPTURES_ONLY);
+    auto result = buildMoveVector(fromState);
+    MoveGenerator fromPosition(testContext.readChessboard().readPosition(), Set::BLACK, PieceType::NONE, MoveTypes::CAPTURES_ONLY);
+    auto expected = buildMoveVector(fromPosition);
+
+    // verify
+    EXPECT_FALSE(result.empty());
+    EXPECT_EQ(expected, result);
+}
+
+TEST_F(MoveGeneratorFixture, Knight_PinnedWhileChecked_CheckersAndPinners)
+{
+    // setup
+    std::string fen = "4r1k1/8/8/8/1b6/8/4N3/4K3 w - - 0 1";
+    FENParser::deserialize(fen.c_str(), testContext);
+
+    // do
+    MoveGenerator gen(testContext);
+    gen.generate();
+
+    // verify
+    EXPECT_TRUE(gen.isChecked());
+    EXPECT_EQ(squareMaskTable[b4.index()], gen.readCheckers<Set::WHITE>().read());
+    EXPECT_EQ(squareMaskTable[e8.index()], gen.readPinners<Set::WHITE>().read());
+    EXPECT_TRUE(gen.readCheckers<Set::BLACK>().empty());
+    EXPECT_TRUE(gen.readPinners<Set::BLACK>().empty());
+
+    // the pinned knight could block on c3 or d2, but can't leave the file, only the king moves.
+    auto result = buildMoveVector(gen);
+    for (const auto& move : result)
+        EXPECT_EQ(e1.toSquare(), move.sourceSqr()) << move.toString();
+    EXPECT_EQ(3, result.size());
+}
+
+namespace {
+template<Set us>
+void verifyMoveValidation(GameContext& context, const std::vector<PackedMove>& generated, const std::vector<bool>& checks)
+{
+    const Position& position = context.readChessboard().readPosition();
+    const CheckInfo checkInfo = position.calcCheckInfo<us>();
+
+    for (size_t i = 0; i < generated.size(); ++i) {
+        const PackedMove move = generated[i];
+        EXPECT_TRUE(position.isPseudoLegal<us>(move)) << move.toString();
+        EXPECT_TRUE(position.isLegal<us>(move)) << move.toString();
+
+        const bool givesCheck = position.givesCheck(move, checkInfo);
+        EXPECT_EQ(givesCheck, checks[i]) << move.toString();
+
+        context.MakeMove(move);
+        EXPECT_EQ(context.readState().checkers.empty() == false, givesCheck) << move.toString();
+        context.UnmakeMove();
+    }
+
+    // every flag the generator uses, a move passing validation has to be one of the generated ones.
+    const u16 flags[] = { QUIET_MOVES, CAPTURES, EN_PASSANT_CAPTURE, KING_CASTLE, QUEEN_CASTLE, KNIGHT_PROMOTION,
+        BISHOP_PROMOTION, ROOK_PROMOTION, QUEEN_PROMOTION, KNIGHT_PROMO_CAPTURE, BISHOP_PROMO_CAPTURE,
+        ROOK_PROMO_CAPTURE, QUEEN_PROMO_CAPTURE };
+    for (u16 source = 0; source < 64; ++source) {
+        for (u16 target = 0; target < 64; ++target) {
+            for (u16 flag : flags) {
+                const PackedMove move(static_cast<u16>(source | (target << 6) | (flag << 12)));
+                if (position.isPseudoLegal<us>(move) && position.isLegal<us>(move)) {
+                    EXPECT_NE(generated.end(), std::find(generated.begin(), generated.end(), move)) << move.toString();
+                }
+            }
+        }
+    }
+}
+}  // namespace
+
+TEST_F(MoveGeneratorFixture, Validation_AgreesWithGenerator)
+{
+    const std::string fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1",
+        "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1",
+        "4k3/1P6/8/8/8/8/K7/8 w - - 0 1",
+        "5k2/8/8/8/8/8/8/4K2R w K - 0 1",
+        "4k3/8/8/8/4N3/8/8/4R1K1 w - - 0 1",
+        "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1",
+    };
+
+    for (const auto& fen : fens) {
+        FENParser::deserialize(fen.c_str(), testContext);
+
+        // the root and every position one move in, which covers en passant and checks.
+        MoveGenerator rootGen(testContext);
+        std::vector<PackedMove> rootMoves = buildMoveVector(rootGen);
+        for (size_t i = 0; i <= rootMoves.size(); ++i) {
+            if (i > 0)
+                testContext.MakeMove(rootMoves[i - 1]);
+
+            MoveGenerator gen(testContext);
+            std::vector<PackedMove> generated;
+            std::vector<bool> checks;
+            for (auto prioratized = gen.generateNextMove(); prioratized.move; prioratized = gen.generateNextMove()) {
+                generated.push_back(prioratized.move);
+                checks.push_back(prioratized.isCheck());
+            }
+
+            if (testContext.readToPlay() == Set::WHITE)
+                verifyMoveValidation<Set::WHITE>(testContext, generated, checks);
+            else
+                verifyMoveValidation<Set::BLACK>(testContext, generated, checks);
+
+            if (i > 0)
+                testContext.UnmakeMove();
+        }
+    }
+}
+
+TEST_F(MoveGeneratorFixture, Evasions_White_BlockOrStepAside)
+{
+    // setup
+    std::string fen = "4k3/8/8/8/8/8/3B4/r3K3 w - - 0 1";
+    FENParser::deserialize(fen.c_str(), testContext);
+
+    // do
+    MoveGenerator gen(testContext);
+    auto result = buildMoveVector(gen);
+
+    // verify, Bc1 is the only interposition, d1 and f1 are still on the rank of the rook.
+    EXPECT_TRUE(gen.isChecked());
+    EXPECT_EQ(3, result.size());
+    EXPECT_NE(result.end(), std::find(result.begin(), result.end(), PackedMove(d2.toSquare(), c1.toSquare())));
+}
+
+TEST_F(MoveGeneratorFixture, Evasions_Black_EnPassantCapturesChecker)
+{
+    // setup
+    std::string fen = "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1";
+    FENParser::deserialize(fen.c_str(), testContext);
+
+    // do
+    MoveGenerator gen(testContext);
+    auto result = buildMoveVector(gen);
+
+    // verify, eight king moves including Kxd4 and exd3 en passant.
+    PackedMove enPassant(e4.toSquare(), d3.toSquare());
+    enPassant.setEnPassant(true);
+    EXPECT_TRUE(gen.isChecked());
+    EXPECT_EQ(9, result.size());
+    EXPECT_NE(result.end(), std::find(result.begin(), result.end(), enPassant));
+}
+
+}  // namespace ElephantTest
@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "fen_parser.h"
+#include "game_context.h"
+#include "move_generator.hpp"
+#include "move_list.hpp"
+
+namespace ElephantTest {
+
+TEST(MoveListTest, Picker_HighestPriorityFirst) {
+    MoveArena::Slot storage;
+    MoveList moves(storage.data());
+    const u16 priorities[] = { 0, 900, 1000, 0, 5000, 800 };
+    for (u16 indx = 0; indx < 6; ++indx)
+        moves.push(PrioratizedMove(PackedMove(static_cast<Square>(indx), static_cast<Square>(indx + 8)), priorities[indx]));
+
+    MovePicker picker;
+    const u16 expected[] = { 5000, 1000, 900, 800, 0, 0 };
+    for (u16 priority : expected) {
+        ASSERT_FALSE(picker.done(moves));
+        EXPECT_EQ(priority, picker.next(moves).priority);
+    }
+    EXPECT_TRUE(picker.done(moves));
+    EXPECT_EQ(6, moves.size());
+}
+
+TEST(MoveListTest, Arena_NestedGeneratorsReuseSlotPerDepth) {
+    GameContext context;
+    FENParser::deserialize("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", context);
+
+    MoveArena& arena = MoveArena::local();
+    const u32 startDepth = arena.depth();
+    u32 rootCount = 0;
+    {
+        MoveGenerator root(context);
+        EXPECT_EQ(startDepth + 1, arena.depth());
+        root.generate();
+
+        // a child generator at the next depth must not clobber the moves of the root.
+        for (u32 i = 0; i < 3; ++i) {
+            MoveGenerator child(context);
+            EXPECT_EQ(startDepth + 2, arena.depth());
+            child.generate();
+        }
+
+        while (root.generateNextMove().move.isNull() == false)
+            ++rootCount;
+    }
+    EXPECT_EQ(startDepth, arena.depth());
+    EXPECT_EQ(48u, rootCount);
+}
+
+TEST(MoveListTest, RangeAndVisitor_SeeTheSameMoves) {
+    GameContext context;
+    FENParser::deserialize("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", context);
+
+    MoveGenerator generator(context);
+    generator.generate();
+
+    std::vector<PackedMove> visited;
+    generator.forEachMove([&](const PrioratizedMove& pm) { visited.push_back(pm.move); });
+
+    std::vector<PackedMove> ranged;
+    for (const PrioratizedMove& pm : generator)
+        ranged.push_back(pm.move);
+
+    EXPECT_EQ(48u, ranged.size());
+    EXPECT_EQ(visited, ranged);
+}
+
+}  // namespace ElephantTest
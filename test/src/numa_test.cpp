@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "numa.hpp"
+#include "transposition_table.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace ElephantTest {
+
+TEST(NumaTest, ParseCpuList_RangesAndSingles) {
+    std::vector<u32> expected = { 0, 1, 2, 3, 8, 10, 11 };
+    EXPECT_EQ(expected, numa::parseCpuList("0-3,8,10-11\n"));
+    EXPECT_TRUE(numa::parseCpuList("").empty());
+    EXPECT_EQ(expected, numa::parseCpuList(" 0 - 3,\t8, 10-11 "));
+}
+
+TEST(NumaTest, Topology_ReadsNodeDirectory) {
+    namespace fs = std::filesystem;
+    const fs::path root = fs::temp_directory_path() / "elephant_numa_test";
+    fs::remove_all(root);
+    fs::create_directories(root / "node0");
+    fs::create_directories(root / "node1");
+    // memory only node without cpus.
+    fs::create_directories(root / "node2");
+    fs::create_directories(root / "power");
+    // bytes above 0x7f are negative chars, they must not reach the character classification as is.
+    fs::create_directories(root / "node\xc3\xa9");
+    std::ofstream(root / "node0" / "cpulist") << "0-1\n";
+    std::ofstream(root / "node1" / "cpulist") << "2-3\n";
+    std::ofstream(root / "node2" / "cpulist") << "\n";
+
+    numa::Topology topology(root.string());
+    ASSERT_EQ(2, topology.readNodeCount());
+    EXPECT_EQ(4, topology.readCpuCount());
+
+    // threads alternate between the nodes before filling up the cpus of a node.
+    EXPECT_EQ(0, topology.cpuForThread(0));
+    EXPECT_EQ(2, topology.cpuForThread(1));
+    EXPECT_EQ(1, topology.cpuForThread(2));
+    EXPECT_EQ(3, topology.cpuForThread(3));
+    EXPECT_EQ(0, topology.cpuForThread(4));
+    EXPECT_EQ(1, topology.nodeForThread(3).id);
+
+    fs::remove_all(root);
+}
+
+TEST(NumaTest, Topology_MissingDirectoryIsSingleNode) {
+    numa::Topology topology("/nonexistent/elephant/node");
+    ASSERT_EQ(1, topology.readNodeCount());
+    EXPECT_GE(topology.readCpuCount(), 1);
+}
+
+TEST(NumaTest, ParallelFill_ZeroesEverything) {
+    for (auto placement : { numa::Placement::FirstTouch, numa::Placement::Interleave }) {
+        // not a multiple of the chunk size nor of the thread count.
+        std::vector<byte> buffer(numa::c_interleaveChunkSize * 3 + 12345, 0xff);
+        numa::parallelFill(buffer.data(), buffer.size(), 3, placement);
+        EXPECT_TRUE(std::all_of(buffer.begin(), buffer.end(), [](byte value) { return value == 0; }));
+    }
+}
+
+TEST(NumaTest, TranspositionTable_PlacementKeepsSize) {
+    TranspositionTable table;
+    table.setPlacement(4, numa::Placement::Interleave);
+    table.resize(16);
+    EXPECT_EQ(16, table.readSizeMegaBytes());
+
+    const u64 hash = 0x1234567890abcdef;
+    table.editEntry(hash).update(hash, PackedMove(Square::E2, Square::E4), 0, 10, 1, 4, TTF_CUT_EXACT);
+    EXPECT_EQ(PackedMove(Square::E2, Square::E4), table.probe(hash));
+
+    table.clear();
+    EXPECT_TRUE(table.probe(hash).isNull());
+}
+
+}  // namespace ElephantTest
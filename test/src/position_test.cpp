@@ -1,6 +1,7 @@
 #include "position.hpp"
 #include <gtest/gtest.h>
 #include <array>
+#include "attack_maps.hpp"
 #include "chess_piece.h"
 #include "elephant_test_utils.h"
 #include "notation.h"
@@ -2829,4 +2830,149 @@ TEST_F(PositionFixture, KingMask_Threatened_KingisPierced)
     EXPECT_EQ(expected, orthogonal);
 }
 
-}  // namespace ElephantTest
\ No newline at end of file
+// 8 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 7 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 6 [ . ][ . ][ . ][ . ][ . ][ p ][ . ][ . ]
+// 5 [ . ][ . ][ . ][ . ][ n ][ . ][ . ][ . ]
+// 4 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 3 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 2 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 1 [ . ][ . ][ . ][ . ][ Q ][ . ][ . ][ . ]
+//     A    B    C    D    E    F    G    H
+TEST_F(PositionFixture, StaticExchange_QueenTakesDefendedKnight_LosesMaterial)
+{
+    Position board;
+    board.PlacePiece(WHITEQUEEN, e1.toSquare());
+    board.PlacePiece(BLACKKNIGHT, e5.toSquare());
+    board.PlacePiece(BLACKPAWN, f6.toSquare());
+
+    i32 expected = ChessPieceDef::Value(knightId) - ChessPieceDef::Value(queenId);
+    EXPECT_EQ(expected, board.calcStaticExchangeEvaluation(e1.toSquare(), e5.toSquare()));
+}
+
+// 8 [ . ][ . ][ . ][ . ][ r ][ . ][ . ][ . ]
+// 7 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 6 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 5 [ . ][ . ][ . ][ . ][ p ][ . ][ . ][ . ]
+// 4 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 3 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 2 [ . ][ . ][ . ][ . ][ R ][ . ][ . ][ . ]
+// 1 [ . ][ . ][ . ][ . ][ Q ][ . ][ . ][ . ]
+//     A    B    C    D    E    F    G    H
+TEST_F(PositionFixture, StaticExchange_RookBackedByQueenTakesPawn_XRayWinsPawn)
+{
+    Position board;
+    board.PlacePiece(WHITEQUEEN, e1.toSquare());
+    board.PlacePiece(WHITEROOK, e2.toSquare());
+    board.PlacePiece(BLACKPAWN, e5.toSquare());
+    board.PlacePiece(BLACKROOK, e8.toSquare());
+
+    // RxP, rxR, QxR leaves white a pawn up.
+    i32 expected = ChessPieceDef::Value(pawnId);
+    EXPECT_EQ(expected, board.calcStaticExchangeEvaluation(e2.toSquare(), e5.toSquare()));
+
+    // without the queen behind the rook the exchange loses the rook for a pawn.
+    board.ClearPiece(WHITEQUEEN, e1.toSquare());
+    expected = ChessPieceDef::Value(pawnId) - ChessPieceDef::Value(rookId);
+    EXPECT_EQ(expected, board.calcStaticExchangeEvaluation(e2.toSquare(), e5.toSquare()));
+}
+
+TEST_F(PositionFixture, Material_MinorPiecesOnly_InsufficientMaterial)
+{
+    Position board;
+    board.PlacePiece(WHITEKING, e1.toSquare());
+    board.PlacePiece(BLACKKING, e8.toSquare());
+    EXPECT_TRUE(board.isInsufficientMaterial());
+
+    board.PlacePiece(WHITEKNIGHT, b1.toSquare());
+    EXPECT_TRUE(board.isInsufficientMaterial());
+
+    // knight and bishop can mate.
+    board.PlacePiece(WHITEBISHOP, c1.toSquare());
+    EXPECT_FALSE(board.isInsufficientMaterial());
+
+    // bishops all on the same colored squares can't.
+    board.ClearPiece(WHITEKNIGHT, b1.toSquare());
+    board.PlacePiece(BLACKBISHOP, f8.toSquare());
+    EXPECT_TRUE(board.isInsufficientMaterial());
+
+    board.PlacePiece(BLACKBISHOP, c8.toSquare());
+    EXPECT_FALSE(board.isInsufficientMaterial());
+
+    board.ClearPiece(BLACKBISHOP, c8.toSquare());
+    board.PlacePiece(WHITEPAWN, a2.toSquare());
+    EXPECT_FALSE(board.isInsufficientMaterial());
+}
+
+// 8 [ . ][ . ][ . ][ . ][ r ][ . ][ . ][ . ]
+// 7 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 6 [ . ][ . ][ . ][ . ][ . ][ p ][ . ][ . ]
+// 5 [ . ][ . ][ . ][ . ][ n ][ . ][ . ][ . ]
+// 4 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 3 [ . ][ . ][ . ][ . ][ . ][ . ][ . ][ . ]
+// 2 [ . ][ B ][ . ][ . ][ R ][ . ][ . ][ . ]
+// 1 [ . ][ . ][ . ][ . ][ K ][ . ][ . ][ N ]
+//     A    B    C    D    E    F    G    H
+TEST_F(PositionFixture, AttackMaps_MatchThreatenedSquares)
+{
+    Position board;
+    board.PlacePiece(WHITEKING, e1.toSquare());
+    board.PlacePiece(WHITEKNIGHT, h1.toSquare());
+    board.PlacePiece(WHITEBISHOP, b2.toSquare());
+    board.PlacePiece(WHITEROOK, e2.toSquare());
+    board.PlacePiece(BLACKKNIGHT, e5.toSquare());
+    board.PlacePiece(BLACKPAWN, f6.toSquare());
+    board.PlacePiece(BLACKROOK, e8.toSquare());
+
+    AttackMaps maps(board);
+    u64 expectedWhite = board.calcThreatenedSquares<Set::WHITE, false, true>().read();
+    EXPECT_EQ(expectedWhite, maps.bySet(Set::WHITE).read());
+    u64 expectedBlack = board.calcThreatenedSquares<Set::BLACK, false, true>().read();
+    EXPECT_EQ(expectedBlack, maps.bySet(Set::BLACK).read());
+
+    EXPECT_EQ(board.calcThreatenedSquaresRookBulk<Set::WHITE>().read(), maps.byPiece(Set::WHITE, rookId).read());
+    EXPECT_EQ(board.calcThreatenedSquaresKnightBulk<Set::BLACK>().read(), maps.bySquare(e5.toSquare()).read());
+    EXPECT_TRUE(maps.bySquare(a1.toSquare()).empty());
+
+    EXPECT_TRUE(maps.isAttacked(Set::BLACK, e6.toSquare()));
+    EXPECT_TRUE(maps.isAttacked(Set::WHITE, e5.toSquare()));
+    EXPECT_FALSE(maps.isAttacked(Set::WHITE, e6.toSquare()));
+}
+
+TEST_F(PositionFixture, StaticExchange_WithAttackMaps_MatchesFullExchange)
+{
+    Position board;
+    board.PlacePiece(WHITEKING, g1.toSquare());
+    board.PlacePiece(WHITEQUEEN, e1.toSquare());
+    board.PlacePiece(WHITEROOK, e2.toSquare());
+    board.PlacePiece(WHITEBISHOP, b2.toSquare());
+    board.PlacePiece(BLACKKING, g8.toSquare());
+    board.PlacePiece(BLACKKNIGHT, e5.toSquare());
+    board.PlacePiece(BLACKPAWN, f6.toSquare());
+    board.PlacePiece(BLACKPAWN, a3.toSquare());
+    board.PlacePiece(BLACKROOK, e8.toSquare());
+
+    AttackMaps maps(board);
+    // defended target and undefended target.
+    const Square captures[][2] = { { e2.toSquare(), e5.toSquare() },
+                                   { b2.toSquare(), a3.toSquare() } };
+    for (const auto& capture : captures) {
+        EXPECT_EQ(board.calcStaticExchangeEvaluation(capture[0], capture[1]),
+                  board.calcStaticExchangeEvaluation(capture[0], capture[1], maps));
+    }
+
+    // the pawn on e4 looks undefended, but Re6xe4 uncovers the rook on e8 which recaptures.
+    Position xray;
+    xray.PlacePiece(WHITEKING, g1.toSquare());
+    xray.PlacePiece(WHITEROOK, e6.toSquare());
+    xray.PlacePiece(BLACKKING, g8.toSquare());
+    xray.PlacePiece(BLACKROOK, e8.toSquare());
+    xray.PlacePiece(BLACKPAWN, e4.toSquare());
+
+    AttackMaps xrayMaps(xray);
+    const i32 expected = xray.calcStaticExchangeEvaluation(e6.toSquare(), e4.toSquare());
+    EXPECT_LT(expected, 0);
+    EXPECT_EQ(expected, xray.calcStaticExchangeEvaluation(e6.toSquare(), e4.toSquare(), xrayMaps));
+}
+
+}  // namespace ElephantTest
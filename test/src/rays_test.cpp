@@ -23,4 +23,52 @@ TEST(RaysTest, Rays) {
 
     u64 result = ray::getRay(*from, *to);
     EXPECT_EQ(expected, result);
-}
\ No newline at end of file
+}
+
+TEST(RaysTest, PextPdep_RoundTripRelevantOccupancy) {
+    const u64 mask = attacks::tables::getRookAttacks()[*Square::D4];
+    const u64 occupancy = 0x0008000800220000ull;
+    const u64 index = intrinsics::pext(occupancy, mask);
+    EXPECT_EQ(occupancy & mask, intrinsics::pdep(index, mask));
+    EXPECT_LT(index, 1ull << intrinsics::popcnt(mask));
+}
+
+TEST(RaysTest, SliderLookups_MatchGeneratedAttacks) {
+    // whichever backend is compiled in has to agree with the slow reference generators.
+    u64 seed = 0x9E3779B97F4A7C15ull;
+    for (u8 sqr = 0; sqr < 64; ++sqr) {
+        for (u32 i = 0; i < 64; ++i) {
+            seed ^= seed << 13;
+            seed ^= seed >> 7;
+            seed ^= seed << 17;
+            const u64 occupancy = seed & (seed >> 3);
+            EXPECT_EQ(attacks::internals::generateRookAttackMask<true>(sqr, occupancy), attacks::getRookAttacks(sqr, occupancy));
+            EXPECT_EQ(attacks::internals::generateBishopAttackMask<true>(sqr, occupancy), attacks::getBishopAttacks(sqr, occupancy));
+        }
+    }
+}
+
+TEST(RaysTest, SliderTable_PackedSlicesCoverEveryOccupancy) {
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(attacks::tables::getSliderAttacksTable().data()) % 64);
+
+    // every relevant occupancy of a square has to land inside the square's own slice.
+    for (u8 sqr = 0; sqr < 64; ++sqr) {
+        const u64 rookMask = attacks::tables::getRookAttacks()[sqr];
+        const u64 bishopMask = attacks::tables::getBishopAttacks()[sqr];
+        const u64 rookSlice = attacks::internals::rookOffsets[sqr + 1] - attacks::internals::rookOffsets[sqr];
+        const u64 bishopSlice = attacks::internals::bishopOffsets[sqr + 1] - attacks::internals::bishopOffsets[sqr];
+        EXPECT_GE(rookSlice, 1ull << intrinsics::popcnt(rookMask));
+        EXPECT_GE(bishopSlice, 1ull << intrinsics::popcnt(bishopMask));
+
+        for (u64 i = 0; i < (1ull << intrinsics::popcnt(rookMask)); ++i) {
+            const u64 occupancy = intrinsics::pdep(i, rookMask);
+            EXPECT_LT(attacks::internals::rookTableIndex(sqr, occupancy), rookSlice);
+            EXPECT_EQ(attacks::internals::generateRookAttackMask<true>(sqr, occupancy), attacks::getRookAttacks(sqr, occupancy));
+        }
+        for (u64 i = 0; i < (1ull << intrinsics::popcnt(bishopMask)); ++i) {
+            const u64 occupancy = intrinsics::pdep(i, bishopMask);
+            EXPECT_LT(attacks::internals::bishopTableIndex(sqr, occupancy), bishopSlice);
+            EXPECT_EQ(attacks::internals::generateBishopAttackMask<true>(sqr, occupancy), attacks::getBishopAttacks(sqr, occupancy));
+        }
+    }
+}
@@ -78,6 +78,22 @@ TEST_F(SearchFixture, WhiteForcedMate)
     EXPECT_TRUE(result.ForcedMate);
 }
 
+TEST_F(SearchFixture, NodeLimit_StopsWithinAFewNodesOfTheLimit)
+{
+    GameContext context;
+    context.NewGame();
+
+    SearchParameters params;
+    params.SearchDepth = 10;
+    params.NodeLimit = 500;
+
+    SearchResult result = context.CalculateBestMove(params);
+    EXPECT_FALSE(result.move.isNull());
+    // only the nodes already on the stack are counted while unwinding past the limit.
+    EXPECT_GE(context.readSearch().readNodesSearched(), params.NodeLimit);
+    EXPECT_LE(context.readSearch().readNodesSearched(), params.NodeLimit + c_maxSearchDepth + c_maxQuiescenceDepth);
+}
+
 TEST_F(SearchFixture, MateAgainstSelf)
 {
     std::string fen("r4b2/1p4p1/p5k1/2p5/6pK/4Pq2/P1n2P1P/3R3R w - - 6 34");
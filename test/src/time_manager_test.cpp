@@ -0,0 +1,71 @@
+#include <gtest/gtest.h>
+#include "search.hpp"
+#include "time_manager.hpp"
+
+namespace ElephantTest {
+
+TEST(TimeManagerTest, NoLimits_NoTimeLimit) {
+    TimeManager tm;
+    SearchParameters params;
+    params.SearchDepth = 5;
+    tm.begin(params, Set::WHITE);
+
+    EXPECT_FALSE(tm.hasTimeLimit());
+    EXPECT_FALSE(tm.softLimitReached());
+    EXPECT_FALSE(tm.hardLimitReached());
+}
+
+TEST(TimeManagerTest, MoveTime_SoftAndHardAreEqual) {
+    TimeManager tm;
+    SearchParameters params;
+    params.MoveTime = 1000;
+    tm.begin(params, Set::WHITE);
+
+    i64 expected = 1000 - time_manager_constants::moveOverhead;
+    EXPECT_EQ(expected, tm.readSoftLimit());
+    EXPECT_EQ(expected, tm.readHardLimit());
+
+    // fixed move time isn't affected by search stability.
+    tm.update(PackedMove(Square::A2, Square::A3), 0, 10, 100);
+    EXPECT_EQ(expected, tm.readSoftLimit());
+}
+
+TEST(TimeManagerTest, SuddenDeath_UsesOwnClockAndMovesToGo) {
+    TimeManager tm;
+    SearchParameters params;
+    params.WhiteTimelimit = 60000;
+    params.BlackTimelimit = 1000;
+    tm.begin(params, Set::WHITE);
+
+    EXPECT_EQ(60000 / time_manager_constants::defaultMovesToGo, tm.readSoftLimit());
+    EXPECT_EQ(tm.readSoftLimit() * time_manager_constants::hardLimitFactor, tm.readHardLimit());
+
+    params.MovesToGo = 10;
+    tm.begin(params, Set::WHITE);
+    EXPECT_EQ(6000, tm.readSoftLimit());
+
+    // last move before the time control, hard limit can use everything but the overhead.
+    params.MovesToGo = 1;
+    tm.begin(params, Set::WHITE);
+    EXPECT_EQ(60000 - time_manager_constants::moveOverhead, tm.readHardLimit());
+}
+
+TEST(TimeManagerTest, Stability_StableBestMoveShrinksSoftLimit) {
+    TimeManager tm;
+    SearchParameters params;
+    params.BlackTimelimit = 60000;
+    tm.begin(params, Set::BLACK);
+    const i64 base = tm.readSoftLimit();
+
+    PackedMove move(Square::E7, Square::E5);
+    for (int i = 0; i < 8; ++i)
+        tm.update(move, 20, 900, 1000);
+    EXPECT_LT(tm.readSoftLimit(), base);
+
+    // best move changing and the score dropping should grant more time than base.
+    tm.update(PackedMove(Square::D7, Square::D5), -200, 300, 1000);
+    EXPECT_GT(tm.readSoftLimit(), base);
+    EXPECT_LE(tm.readSoftLimit(), tm.readHardLimit());
+}
+
+}  // namespace ElephantTest
@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <set>
 #include "elephant_test_utils.h"
 
 #include "fen_parser.h"
@@ -247,4 +248,132 @@ TEST_F(UciFixture, go_depth_3_DoesASearchAndReturnsAMove)
     EXPECT_TRUE(result);
 }
 
+TEST_F(UciFixture, go_nodes_5000_NodeLimitedSearchIsDeterministic)
+{
+    // setup
+    m_uci.Enable();
+    m_uci.NewGame();
+
+    std::string outputs[2];
+    for (auto& output : outputs) {
+        std::string commandLine = "go nodes 5000";
+        std::list<std::string> args;
+        extractArgsFromCommand(commandLine, args);
+        args.pop_front();  // pop go
+        bool result = false;
+        std::stringstream testOutput;
+        {
+            ScopedRedirect coutRedirect(std::cout, testOutput);
+            result = m_uci.Go(args);
+        }
+
+        EXPECT_TRUE(result);
+        output = testOutput.str();
+        auto bestmove = output.find("bestmove ");
+        ASSERT_NE(std::string::npos, bestmove);
+        output = output.substr(bestmove);
+        EXPECT_EQ(std::string::npos, output.find("0000"));
+    }
+
+    EXPECT_EQ(outputs[0], outputs[1]);
+}
+
+TEST_F(UciFixture, go_mate_5_ReportsMateAndBestMove)
+{
+    // setup
+    m_uci.Enable();
+    std::list<std::string> args;
+    extractArgsFromCommand("position fen 2q1nk1r/4Rp2/1ppp1P2/6Pp/3p1B2/3P3P/PPP1Q3/6K1 w - - 0 1", args);
+    args.pop_front();  // pop position
+    ASSERT_TRUE(m_uci.Position(args));
+
+    args.clear();
+    extractArgsFromCommand("go mate 5", args);
+    args.pop_front();  // pop go
+    bool result = false;
+    std::stringstream testOutput;
+    {
+        ScopedRedirect coutRedirect(std::cout, testOutput);
+        result = m_uci.Go(args);
+    }
+
+    // verify
+    EXPECT_TRUE(result);
+    std::string output = testOutput.str();
+    EXPECT_NE(std::string::npos, output.find(" score mate "));
+    EXPECT_NE(std::string::npos, output.find("bestmove e7e8"));
+}
+
+TEST_F(UciFixture, go_searchmoves_BestMoveIsOneOfSearchMoves)
+{
+    // setup
+    m_uci.Enable();
+    m_uci.NewGame();
+
+    std::list<std::string> args;
+    extractArgsFromCommand("go depth 3 searchmoves a2a3 h2h4", args);
+    args.pop_front();  // pop go
+    bool result = false;
+    std::stringstream testOutput;
+    {
+        ScopedRedirect coutRedirect(std::cout, testOutput);
+        result = m_uci.Go(args);
+    }
+
+    // verify
+    EXPECT_TRUE(result);
+    std::string output = testOutput.str();
+    auto bestmove = output.find("bestmove ");
+    ASSERT_NE(std::string::npos, bestmove);
+    std::string move = output.substr(bestmove + 9, 4);
+    EXPECT_TRUE(move == "a2a3" || move == "h2h4") << move;
+    EXPECT_EQ(std::string::npos, output.find(" pv g1f3"));
+}
+
+TEST_F(UciFixture, go_searchmoves_IllegalMoveFails)
+{
+    // setup
+    m_uci.Enable();
+    m_uci.NewGame();
+
+    std::list<std::string> args;
+    extractArgsFromCommand("go depth 3 searchmoves e2e5", args);
+    args.pop_front();  // pop go
+
+    // verify
+    EXPECT_FALSE(m_uci.Go(args));
+}
+
+TEST_F(UciFixture, setoption_MultiPV_3_ReportsThreeDistinctLines)
+{
+    // setup
+    m_uci.Enable();
+    m_uci.NewGame();
+    ASSERT_TRUE(m_uci.SetOption({ "name", "MultiPV", "value", "3" }));
+
+    std::list<std::string> args;
+    extractArgsFromCommand("go depth 3", args);
+    args.pop_front();  // pop go
+    bool result = false;
+    std::stringstream testOutput;
+    {
+        ScopedRedirect coutRedirect(std::cout, testOutput);
+        result = m_uci.Go(args);
+    }
+
+    // verify
+    EXPECT_TRUE(result);
+    std::string output = testOutput.str();
+    std::set<std::string> firstMoves;
+    for (u32 k = 1; k <= 3; ++k) {
+        auto line = output.find("info depth 3 multipv " + std::to_string(k) + " ");
+        ASSERT_NE(std::string::npos, line);
+        auto pv = output.find(" pv ", line);
+        ASSERT_NE(std::string::npos, pv);
+        firstMoves.insert(output.substr(pv + 4, 4));
+    }
+    EXPECT_EQ(3, firstMoves.size());
+    EXPECT_EQ(std::string::npos, output.find("multipv 4"));
+}
+
 }  // namespace ElephantTest
\ No newline at end of file
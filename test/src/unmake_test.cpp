@@ -4,6 +4,7 @@
 #include "chess_piece.h"
 #include "chessboard.h"
 #include "elephant_test_utils.h"
+#include "fen_parser.h"
 #include "game_context.h"
 #include "log.h"
 #include "move.h"
@@ -778,4 +779,83 @@ TEST_F(UnmakeFixture, BishopCaptureRookRemovesCastlingOption)
 
 // ////////////////////////////////////////////////////////////////
 
+// verifies the mailbox against the bitboards on every square.
+static void expectMailboxInSync(const Position& position)
+{
+    const auto& material = position.readMaterial();
+    for (u8 sqr = 0; sqr < 64; ++sqr) {
+        ChessPiece expected = ChessPiece::None();
+        for (u8 set = 0; set < 2; ++set) {
+            for (u8 pieceId = 0; pieceId < 6; ++pieceId) {
+                if (material.read(static_cast<Set>(set), pieceId)[static_cast<Square>(sqr)])
+                    expected = ChessPiece(set, pieceId);
+            }
+        }
+        EXPECT_EQ(expected, position.readPieceAt(static_cast<Square>(sqr))) << Notation::toString(static_cast<Square>(sqr));
+    }
+}
+
+static void makeUnmakeAll(GameContext& context, u32 depth)
+{
+    if (depth == 0)
+        return;
+
+    MoveGenerator generator(context);
+    generator.generate();
+    generator.forEachMove([&](const PrioratizedMove& mv) {
+        context.MakeMove(mv.move);
+        expectMailboxInSync(context.readChessboard().readPosition());
+        makeUnmakeAll(context, depth - 1);
+        context.UnmakeMove();
+        expectMailboxInSync(context.readChessboard().readPosition());
+        });
+}
+
+// kiwipete and a promotion heavy position cover castling, en passant, captures and promotions.
+TEST_F(UnmakeFixture, Mailbox_MakeUnmake_StaysInSyncWithBitboards)
+{
+    for (const char* fen : { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                             "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1" }) {
+        GameContext context;
+        FENParser::deserialize(fen, context);
+        expectMailboxInSync(context.readChessboard().readPosition());
+        makeUnmakeAll(context, 2);
+    }
+}
+
+// restoring a snapshot has to leave the board exactly as unmaking the move does.
+TEST_F(UnmakeFixture, Snapshot_Restore_MatchesUnmake)
+{
+    for (const char* fen : { "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+                             "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+                             "8/8/8/2k5/3Pp3/8/8/4K3 b - d3 0 1" }) {
+        GameContext context;
+        FENParser::deserialize(fen, context);
+        Chessboard& board = context.editChessboard();
+
+        MoveGenerator generator(context);
+        generator.generate();
+        for (const PrioratizedMove& mv : generator) {
+            Chessboard unmade = board;
+            auto undo = unmade.MakeMove<false>(mv.move);
+            unmade.UnmakeMove(undo);
+
+            BoardSnapshot snapshot;
+            board.SaveSnapshot(snapshot);
+            board.MakeMove<false>(mv.move);
+            board.RestoreSnapshot(snapshot);
+
+            expectMailboxInSync(board.readPosition());
+            EXPECT_EQ(unmade.readHash(), board.readHash()) << mv.move.toString();
+            EXPECT_EQ(unmade.readPlyCount(), board.readPlyCount());
+            EXPECT_EQ(unmade.readMoveCount(), board.readMoveCount());
+            EXPECT_EQ(unmade.readToPlay(), board.readToPlay());
+            EXPECT_EQ(unmade.readCastlingState().read(), board.readCastlingState().read());
+            EXPECT_EQ(unmade.readPosition().readEnPassant().read(), board.readPosition().readEnPassant().read());
+            for (u8 sqr = 0; sqr < 64; ++sqr)
+                EXPECT_EQ(unmade.readPieceAt(static_cast<Square>(sqr)), board.readPieceAt(static_cast<Square>(sqr)));
+        }
+    }
+}
+
 }  // namespace ElephantTest
\ No newline at end of file